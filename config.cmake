@@ -324,25 +324,12 @@ if(SEL4_CONFIG_DEFAULT_ADVANCED)
 endif()
 
 config_string(
-    KernelNumPriorities NUM_PRIORITIES "The number of priority levels per domain. Valid range 1-256"
+    KernelNumPriorities NUM_PRIORITIES "The number of priority levels per domain. Valid range 1-256, \
+    or 1 up to the square of the word size in bits with KernelPackedReadyQueues."
     DEFAULT 256
     UNQUOTE
 )
 
-config_string(
-    KernelMaxNumNodes MAX_NUM_NODES "Max number of CPU cores to boot"
-    DEFAULT 1
-    DEPENDS "${KernelNumDomains} EQUAL 1"
-    UNQUOTE
-)
-
-# Set CONFIG_ENABLE_SMP_SUPPORT as an alias of CONFIG_MAX_NUM_NODES > 1
-if(KernelMaxNumNodes GREATER 1)
-    config_set(KernelEnableSMPSupport ENABLE_SMP_SUPPORT ON)
-else()
-    config_set(KernelEnableSMPSupport ENABLE_SMP_SUPPORT OFF)
-endif()
-
 config_string(
     KernelStackBits KERNEL_STACK_BITS
     "This describes the log2 size of the kernel stack. Great care should be taken as\
@@ -381,6 +368,193 @@ config_option(
     DEPENDS "KernelVerificationBuild"
 )
 
+config_option(
+    KernelTickless TICKLESS
+    "Only take a timer interrupt when a timeslice or the domain time runs out, \
+    instead of every KernelTimerTickMS. The ticks that have passed are counted \
+    on the next kernel entry. With a single domain, a core stops its timer \
+    altogether while it runs the idle thread or a thread that has no other \
+    ready thread of the same priority."
+    DEFAULT OFF
+    DEPENDS "NOT KernelIsMCS; KernelArchX86; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelUntypedReset UNTYPED_RESET
+    "Provide the Untyped_Reset invocation. It zeroes the used part of an untyped \
+    object without creating new objects, in chunks of KernelResetChunkBits with \
+    preemption points in between, and records its progress in the free index of \
+    the cap. A low priority thread can use it to clean untyped memory ahead of \
+    time, so that a later Retype does not have to zero it."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelBatchedRevoke BATCHED_REVOKE
+    "Delete runs of untyped and frame capabilities during a revoke in one batch \
+    that clears the slots and unlinks the whole run from the derivation tree at \
+    once, instead of deleting and unlinking every capability on its own. Speeds \
+    up revoking large untyped objects with many derived frames."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelPreemptibleBadgedSends PREEMPTIBLE_BADGED_SENDS
+    "Make cancelling badged sends on an endpoint preemptible. The scan of the \
+    send queue checks for pending interrupts as it goes and, when preempted, \
+    records the next sender to look at in the invoking thread so the restarted \
+    invocation continues from there instead of rescanning the whole queue. \
+    Bounds the time spent in the kernel when revoking one badge on an endpoint \
+    with many blocked senders."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelFastpathExtraCap FASTPATH_EXTRA_CAP
+    "Allow the Call and ReplyRecv fastpaths to handle messages carrying a single \
+    extra endpoint capability, either unwrapped into a badge or copied into the \
+    receiver's receive slot. Messages with any other kind of extra capability still \
+    take the slowpath."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelIPCBurstCopy IPC_BURST_COPY
+    "Copy the message words of an IPC that do not fit in registers between the IPC \
+    buffers a cache line at a time, instead of one word at a time."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelFastpathLongMessages FASTPATH_LONG_MESSAGES
+    "Allow the Call and ReplyRecv fastpaths to handle messages of up to \
+    KernelFastpathMaxMsgLength words. The words that do not fit in the message \
+    registers are copied between the IPC buffers of the two threads."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath; KernelIPCBurstCopy; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelFastpathMaxMsgLength FASTPATH_MAX_MSG_LENGTH
+    "Longest message, in words, that the Call and ReplyRecv fastpaths transfer. \
+    Must be more than the number of message registers and at most seL4_MsgMaxLength."
+    DEFAULT 120
+    DEPENDS "KernelFastpathLongMessages"
+    UNDEF_DISABLED UNQUOTE
+)
+
+config_option(
+    KernelMessageWindow MESSAGE_WINDOW
+    "Give each thread an optional message window: a virtual address at which a single \
+    frame is mapped. An IPC with grant rights from a thread whose window holds a frame \
+    moves the frame to the receiver's empty window in the same kernel entry, unmapping \
+    it from the sender and mapping it at the receiver's window address."
+    DEFAULT OFF
+    DEPENDS "KernelSel4ArchX86_64; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelCSpaceLookupCache CSPACE_LOOKUP_CACHE
+    "Keep a small per-core cache of recently resolved capability addresses, used \
+    by the slowpath and the fastpath instead of walking every CNode level. All \
+    cached entries are invalidated when a CNode capability is added to, removed \
+    from or replaced in any slot."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelWaitFastpath WAIT_FASTPATH
+    "Enable a fastpath for Recv and NBRecv (and Wait and NBWait on MCS) on a \
+    notification capability. An active notification returns its badge without \
+    going through the slowpath. On non-MCS configurations a thread that blocks is \
+    queued on the notification and the kernel switches directly to the highest \
+    priority runnable thread."
+    DEFAULT OFF
+    DEPENDS "KernelFastpath; KernelArchX86 OR KernelSel4ArchAarch64; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelRuntimeDomainSchedule RUNTIME_DOMAIN_SCHEDULE
+    "Give every core its own domain schedule, which starts out as a copy of \
+    KernelDomainSchedule and can be replaced at run time through the domain \
+    capability. A new schedule is written into a second buffer and takes over \
+    at the end of the current round of the old one. Cores switch domains \
+    independently of each other, which also allows more than one domain on \
+    SMP configurations."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelDomainScheduleMaxLength DOMAIN_SCHEDULE_MAX_LENGTH
+    "Maximum number of entries in a domain schedule configured at run time."
+    DEFAULT 64
+    DEPENDS "KernelRuntimeDomainSchedule"
+    UNQUOTE
+)
+
+config_option(
+    KernelPackedReadyQueues PACKED_READY_QUEUES
+    "Store the ready queues and the priority bitmaps of each domain together, \
+    aligned to a cache line, instead of in separate arrays that are indexed by \
+    domain. Choosing a thread then touches the cache line with the domain's \
+    bitmaps and the line with the queue head, and the state of domains without \
+    runnable threads stays out of the cache. Also allows more than 256 priorities."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelMaxNumNodes MAX_NUM_NODES "Max number of CPU cores to boot"
+    DEFAULT 1
+    DEPENDS "${KernelNumDomains} EQUAL 1 OR KernelRuntimeDomainSchedule"
+    UNQUOTE
+)
+
+# Set CONFIG_ENABLE_SMP_SUPPORT as an alias of CONFIG_MAX_NUM_NODES > 1
+if(KernelMaxNumNodes GREATER 1)
+    config_set(KernelEnableSMPSupport ENABLE_SMP_SUPPORT ON)
+else()
+    config_set(KernelEnableSMPSupport ENABLE_SMP_SUPPORT OFF)
+endif()
+
+config_option(
+    KernelFPUEagerSwitch FPU_EAGER_SWITCH
+    "Count for each thread how often it faults on its first FPU use after a switch. Once \
+    the count reaches KernelFPUEagerThreshold the thread's FPU state is restored when the \
+    kernel returns to it, instead of waiting for the fault. Threads that stop using the \
+    FPU fall back to lazy switching after a fixed number of eager restores."
+    DEFAULT OFF
+    DEPENDS "KernelHaveFPU; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelFPUEagerThreshold FPU_EAGER_THRESHOLD
+    "Number of lazy FPU faults after which a thread's FPU state is restored eagerly."
+    DEFAULT 4
+    DEPENDS "KernelFPUEagerSwitch"
+    UNDEF_DISABLED UNQUOTE
+)
+
 config_option(
     KernelDebugBuild DEBUG_BUILD "Enable debug facilities (symbols and assertions) in the kernel"
     DEFAULT ON
@@ -437,13 +611,53 @@ else()
     config_set(KernelEnableBenchmarks ENABLE_BENCHMARKS OFF)
 endif()
 
+config_option(
+    KernelBenchmarkEntryHistograms BENCHMARK_ENTRY_HISTOGRAMS
+    "Instead of appending a record per kernel entry to the log buffer, count the \
+    durations of kernel entries in log2 histograms kept in kernel memory. Each core \
+    has its own histograms, one per (path, syscall, cap type, invocation label, \
+    fastpath) key. Memory use does not grow with the length of the run, and no log \
+    buffer is needed. The histograms are read with seL4_BenchmarkGetEntryHistogram."
+    DEFAULT OFF
+    DEPENDS "KernelBenchmarksTrackKernelEntries"
+    DEFAULT_DISABLED OFF
+)
+
+config_string(
+    KernelBenchmarkEntryHistogramBits BENCHMARK_ENTRY_HISTOGRAM_BITS
+    "Log2 of the number of keyed kernel entry histograms per core. Each histogram \
+    holds a key and 32 64-bit counters. Entries whose key finds no free histogram \
+    are counted in an additional overflow histogram."
+    DEFAULT 6
+    DEPENDS "KernelBenchmarkEntryHistograms" DEFAULT_DISABLED 0
+    UNQUOTE
+)
+
 # Reflect the existence of kernel Log buffer
-if(KernelBenchmarksTrackKernelEntries OR KernelBenchmarksTracepoints)
+if(
+    (KernelBenchmarksTrackKernelEntries AND NOT KernelBenchmarkEntryHistograms)
+    OR KernelBenchmarksTracepoints
+)
     config_set(KernelLogBuffer KERNEL_LOG_BUFFER ON)
 else()
     config_set(KernelLogBuffer KERNEL_LOG_BUFFER OFF)
 endif()
 
+config_option(
+    KernelSMPNodeLocks SMP_NODE_LOCKS
+    "Give each core a lock for its node-local kernel state and let the Call and \
+    ReplyRecv fastpaths run under that lock and a per-endpoint lock instead of the \
+    big kernel lock. All other kernel entries, including fastpaths that fall back to \
+    the slowpath, still take the big kernel lock, which also waits for the fastpaths \
+    on all other cores to finish. Not available with MCS, debug builds, kernel entry \
+    tracking or the kernel log buffer, which all keep state that is shared between \
+    cores on the fastpath."
+    DEFAULT OFF
+    DEPENDS
+        "KernelEnableSMPSupport;KernelFastpath;NOT KernelIsMCS;NOT KernelDebugBuild;NOT KernelLogBuffer;NOT KernelBenchmarksTrackKernelEntries;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
 config_string(
     KernelMaxNumTracePoints MAX_NUM_TRACE_POINTS
     "Use TRACE_POINT_START(k) and TRACE_POINT_STOP(k) macros for recording data, \
@@ -454,6 +668,17 @@ config_string(
     UNQUOTE
 )
 
+config_option(
+    KernelBenchmarkTracepointsRing BENCHMARK_TRACEPOINTS_RING
+    "Use the tracepoint log buffer as a ring that keeps the most recent entries \
+    instead of stopping when it is full. The buffer is split into one ring per \
+    core, each with a head index that user level can read without entering the \
+    kernel, so tracepoints can be streamed out while the system runs."
+    DEFAULT OFF
+    DEPENDS "KernelBenchmarksTracepoints"
+    DEFAULT_DISABLED OFF
+)
+
 config_option(
     KernelIRQReporting IRQ_REPORTING
     "seL4 does not properly check for and handle spurious interrupts. This can result \
@@ -560,6 +785,92 @@ config_string(
     UNDEF_DISABLED
 )
 
+config_option(
+    KernelReleaseQueueHeap RELEASE_QUEUE_HEAP
+    "Keep the MCS release queue in a binary heap ordered by release time rather than \
+     in a sorted list. Enqueueing a thread whose budget is exhausted and releasing the \
+     earliest thread then take at most logarithmic time in the number of threads waiting \
+     for a refill on the core, instead of a walk over all of them. Threads released at \
+     the same time may wake in a different order than with the sorted list."
+    DEFAULT OFF
+    DEPENDS "KernelIsMCS; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelBatchInvocation BATCH_INVOCATION
+    "Add the seL4_Batch system call, which performs a list of object invocations \
+     stored in a frame in a single kernel entry. This is intended for loaders that \
+     build address spaces and capability spaces with many short invocations, where \
+     the cost of each kernel entry dominates."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelFrameRangeInvocations FRAME_RANGE_INVOCATIONS
+    "Add the Page_MapRange and Page_UnmapRange invocations, which map or unmap a run \
+     of frames held in consecutive capability slots in a single preemptible invocation. \
+     Only supported on x86 and AArch64."
+    DEFAULT OFF
+    DEPENDS "NOT KernelVerificationBuild; NOT KernelSel4ArchAarch32; NOT KernelArchRiscV"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelUntypedRetypeMap UNTYPED_RETYPE_MAP
+    "Provide the Untyped_RetypeMap invocation, which retypes an untyped object \
+    into frames and maps them into a VSpace at consecutive addresses in a single \
+    kernel entry."
+    DEFAULT OFF
+    DEPENDS "KernelFrameRangeInvocations"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelArmContiguousHint ARM_CONTIGUOUS_HINT
+    "Honour the seL4_ARM_ContiguousHint mapping attribute. Once all entries of a \
+    naturally aligned group of 16 page table entries map a physically contiguous \
+    region with the same rights and attributes, the kernel sets the contiguous bit \
+    on the group so that it can be cached as a single TLB entry."
+    DEFAULT OFF
+    DEPENDS "KernelSel4ArchAarch64; NOT KernelEnableSMPSupport; NOT KernelArmSMMU; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelX86DeferredShootdown X86_DEFERRED_SHOOTDOWN
+    "Queue the TLB invalidations that other cores have to perform during a kernel entry \
+    and send them in a single remote call before leaving the kernel, instead of waiting \
+    for one synchronous remote call per invalidation."
+    DEFAULT OFF
+    DEPENDS "KernelSel4ArchX86_64; KernelEnableSMPSupport; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelArmGicV3DeferredDeactivate ARM_GIC_V3_DEFERRED_DEACTIVATE
+    "Run the GICv3 CPU interface with EOImode 1 and let user level choose, per SPI, \
+    to leave the interrupt active instead of masked after the kernel has signalled \
+    it. The interrupt is then deactivated by IRQHandler_Ack or by the next receive \
+    on the notification it signals, which saves the separate Ack. Receiving on an \
+    endpoint counts as a receive on the notification bound to the receiving thread."
+    DEFAULT OFF
+    DEPENDS "KernelArmGicV3; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
+config_option(
+    KernelIRQRateLimit IRQ_RATE_LIMIT
+    "Add an IRQHandler invocation that sets a minimum time between two deliveries \
+    of an interrupt. An interrupt that arrives earlier keeps its line masked and is \
+    delivered to the notification by the kernel timer once the time has passed."
+    DEFAULT OFF
+    DEPENDS "KernelIsMCS; NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+
 config_option(
     KernelClz32 CLZ_32 "Define a __clzsi2 function to count leading zeros for uint32_t arguments. \
                         Only needed on platforms which lack a builtin instruction."
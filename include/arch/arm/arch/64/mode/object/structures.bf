@@ -273,7 +273,9 @@ block pte_page {
     field pte_sw_type               1
     padding                         3
     field UXN                       1
-    padding                         6
+    padding                         1
+    field contiguous                1
+    padding                         4
     field_high page_base_address    36
     field nG                        1
     field AF                        1
@@ -294,7 +296,9 @@ block pte_4k_page {
     field pte_sw_type               1
     padding                         3
     field UXN                       1
-    padding                         6
+    padding                         1
+    field contiguous                1
+    padding                         4
     field_high page_base_address    36
     field nG                        1
     field AF                        1
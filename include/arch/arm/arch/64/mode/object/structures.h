@@ -207,11 +207,13 @@ static inline bool_t pte_is_page_type(pte_t pte)
            pte_get_pte_type(pte) == pte_pte_page;
 }
 
+#define PTE_PAGE_BASE_ADDRESS_MASK 0xfffffffff000ull
+
 /** Return base address for both of pte_4k_page and pte_page */
 static inline uint64_t pte_get_page_base_address(pte_t pte)
 {
     assert(pte_is_page_type(pte));
-    return pte.words[0] & 0xfffffffff000ull;
+    return pte.words[0] & PTE_PAGE_BASE_ADDRESS_MASK;
 }
 
 /** Return base address for both of pte_4k_page and pte_page */
@@ -219,3 +221,38 @@ static inline uint64_t pte_page_ptr_get_page_base_address(pte_t *pt)
 {
     return pte_get_page_base_address(*pt);
 }
+
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+/* The contiguous hint of the vm attributes is kept in a padding bit of the
+ * generated type, so that vm_attributes_new stays the same as on AArch32. */
+#define PTE_CONTIGUOUS_BITS             4
+#define VM_ATTRIBUTES_CONTIGUOUS_HINT   3
+
+/** Return the contiguous bit for both of pte_4k_page and pte_page */
+static inline bool_t pte_get_contiguous(pte_t pte)
+{
+    switch (pte_get_pte_type(pte)) {
+    case pte_pte_4k_page:
+        return pte_pte_4k_page_get_contiguous(pte);
+    case pte_pte_page:
+        return pte_pte_page_get_contiguous(pte);
+    default:
+        return false;
+    }
+}
+
+/** Set the contiguous bit for both of pte_4k_page and pte_page */
+static inline pte_t pte_set_contiguous(pte_t pte, bool_t contiguous)
+{
+    assert(pte_is_page_type(pte));
+    if (pte_get_pte_type(pte) == pte_pte_4k_page) {
+        return pte_pte_4k_page_set_contiguous(pte, contiguous);
+    }
+    return pte_pte_page_set_contiguous(pte, contiguous);
+}
+
+static inline bool_t vm_attributes_get_armContiguousHint(vm_attributes_t attributes)
+{
+    return !!(attributes.words[0] & BIT(VM_ATTRIBUTES_CONTIGUOUS_HINT));
+}
+#endif /* CONFIG_ARM_CONTIGUOUS_HINT */
@@ -20,6 +20,12 @@ void fastpath_signal(word_t cptr, word_t msgInfo)
 NORETURN;
 #endif
 
+#ifdef CONFIG_WAIT_FASTPATH
+static inline
+void fastpath_wait(word_t cptr, syscall_t syscall)
+NORETURN;
+#endif
+
 static inline
 void fastpath_call(word_t cptr, word_t r_msgInfo)
 NORETURN;
@@ -32,6 +32,11 @@ VISIBLE SECTION(".vectors.text");
 void c_handle_fastpath_signal(word_t cptr, word_t msgInfo)
 VISIBLE SECTION(".vectors.text");
 
+#ifdef CONFIG_WAIT_FASTPATH
+void c_handle_fastpath_wait(word_t cptr, word_t msgInfo, syscall_t syscall)
+VISIBLE SECTION(".vectors.text");
+#endif
+
 #ifdef CONFIG_KERNEL_MCS
 void c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo, word_t reply)
 #else
@@ -30,6 +30,9 @@ void write_it_asid_pool(cap_t it_ap_cap, cap_t it_pd_cap);
 extern char arm_vector_table[1];
 
 word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread);
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap);
+#endif
 exception_t handleVMFault(tcb_t *thread, vm_fault_type_t vm_faultType);
 void setVMRoot(tcb_t *tcb);
 bool_t CONST isValidVTableRoot(cap_t cap);
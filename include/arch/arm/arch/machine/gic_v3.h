@@ -307,6 +307,66 @@ static inline void maskInterrupt(bool_t disable, irq_t irq)
     }
 }
 
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+/*
+ * The CPU interface runs with EOImode 1, so writing ICC_EOIR1_EL1 only drops
+ * the running priority and every interrupt has to be deactivated separately
+ * through ICC_DIR_EL1. An SPI in gic_deferred_deactivate is not masked after
+ * it has been signalled. It stays active instead, which keeps the GIC from
+ * signalling it again, and is recorded in gic_pending_deactivate until user
+ * level acknowledges it. Both bitmaps are indexed by IRQT_TO_IDX.
+ */
+#define GIC_IRQ_BITMAP_WORDS ((INT_STATE_ARRAY_SIZE + wordBits - 1) / wordBits)
+
+extern word_t gic_deferred_deactivate[GIC_IRQ_BITMAP_WORDS];
+extern word_t gic_pending_deactivate[GIC_IRQ_BITMAP_WORDS];
+extern word_t gic_num_pending_deactivate;
+
+static inline bool_t isDeactivationDeferred(irq_t irq)
+{
+    word_t idx = IRQT_TO_IDX(irq);
+    return !!(gic_deferred_deactivate[idx / wordBits] & BIT(idx % wordBits));
+}
+
+static inline bool_t isDeactivationPending(irq_t irq)
+{
+    word_t idx = IRQT_TO_IDX(irq);
+    return !!(gic_pending_deactivate[idx / wordBits] & BIT(idx % wordBits));
+}
+
+static inline void setDeactivationDeferred(irq_t irq, bool_t defer)
+{
+    word_t idx = IRQT_TO_IDX(irq);
+    if (defer) {
+        gic_deferred_deactivate[idx / wordBits] |= BIT(idx % wordBits);
+    } else {
+        gic_deferred_deactivate[idx / wordBits] &= ~BIT(idx % wordBits);
+    }
+}
+
+/* Leave the active IRQ active when it is acked by the kernel. */
+static inline void deferDeactivation(irq_t irq)
+{
+    word_t idx = IRQT_TO_IDX(irq);
+    assert(!isDeactivationPending(irq));
+    gic_pending_deactivate[idx / wordBits] |= BIT(idx % wordBits);
+    gic_num_pending_deactivate++;
+}
+
+/* Deactivate an IRQ whose deactivation was deferred, if it is still active. */
+static inline void deactivateInterrupt(irq_t irq)
+{
+    word_t idx = IRQT_TO_IDX(irq);
+    if (isDeactivationPending(irq)) {
+        gic_pending_deactivate[idx / wordBits] &= ~BIT(idx % wordBits);
+        gic_num_pending_deactivate--;
+        /* SPIs may be deactivated from any core */
+        SYSTEM_WRITE_WORD(ICC_DIR_EL1, IRQT_TO_IRQ(irq));
+        isb();
+    }
+}
+#endif /* CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE */
+
 static inline void ackInterrupt(irq_t irq)
 {
     assert(IS_IRQ_VALID(active_irq[CURRENT_CPU_INDEX()])
@@ -314,6 +374,13 @@ static inline void ackInterrupt(irq_t irq)
 
     /* Set End of Interrupt for active IRQ: ICC_EOIR1_EL1 */
     SYSTEM_WRITE_WORD(ICC_EOIR1_EL1, active_irq[CURRENT_CPU_INDEX()]);
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    /* The EOI only dropped the priority, deactivate the IRQ unless that
+     * has been left to user level. */
+    if (IRQT_TO_IRQ(irq) > maxIRQ || !isDeactivationPending(irq)) {
+        SYSTEM_WRITE_WORD(ICC_DIR_EL1, active_irq[CURRENT_CPU_INDEX()] & IRQ_MASK);
+    }
+#endif
     active_irq[CURRENT_CPU_INDEX()] = IRQ_NONE;
 
 }
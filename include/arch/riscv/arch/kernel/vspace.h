@@ -39,6 +39,9 @@ typedef struct findVSpaceForASID_ret findVSpaceForASID_ret_t;
 
 void copyGlobalMappings(pte_t *newlvl1pt);
 word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread);
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap);
+#endif
 lookupPTSlot_ret_t lookupPTSlot(pte_t *lvl1pt, vptr_t vptr);
 exception_t handleVMFault(tcb_t *thread, vm_fault_type_t vm_faultType);
 void unmapPageTable(asid_t, vptr_t vaddr, pte_t *pt);
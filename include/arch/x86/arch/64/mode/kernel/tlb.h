@@ -38,3 +38,45 @@ static inline void invalidateASID(vspace_root_t *vspace, asid_t asid, word_t mas
     SMP_COND_STATEMENT(doRemoteInvalidateASID(vspace, asid, mask));
 }
 
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+compile_assert(tlb_flush_list_limit_sane, CONFIG_X86_TLB_RANGE_FLUSH_LIMIT > 0 &&
+               CONFIG_X86_TLB_RANGE_FLUSH_LIMIT <= 64)
+
+/*
+ * A list of addresses whose translations are invalidated one at a time. An
+ * address stands for the whole page mapped at it, whatever the page size.
+ */
+typedef struct tlb_flush_list {
+    word_t count;
+    vptr_t vptrs[CONFIG_X86_TLB_RANGE_FLUSH_LIMIT];
+} tlb_flush_list_t;
+
+/* Returns false if the list is full */
+static inline bool_t tlbFlushListAdd(tlb_flush_list_t *list, vptr_t vptr)
+{
+    if (list->count == CONFIG_X86_TLB_RANGE_FLUSH_LIMIT) {
+        return false;
+    }
+    list->vptrs[list->count] = vptr;
+    list->count++;
+    return true;
+}
+
+static inline void invalidateLocalPCIDList(asid_t asid, word_t count, vptr_t *vptrs)
+{
+    for (word_t i = 0; i < count; i++) {
+        invalidateLocalPCID(INVPCID_TYPE_ADDR, (void *)vptrs[i], asid);
+    }
+}
+
+/*
+ * Remote cores read the list from the stack of the caller, which is fine as
+ * the caller waits for all of them to complete the remote call.
+ */
+static inline void invalidatePCIDList(asid_t asid, tlb_flush_list_t *list, word_t mask)
+{
+    invalidateLocalPCIDList(asid, list->count, list->vptrs);
+    SMP_COND_STATEMENT(doRemoteInvalidatePCIDList(asid, list->count, list->vptrs, mask));
+}
+#endif /* CONFIG_X86_RANGED_TLB_FLUSH */
+
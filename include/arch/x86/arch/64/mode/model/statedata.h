@@ -28,6 +28,28 @@ extern pdpte_t x64KSSKIMPDPT[BIT(PDPT_INDEX_BITS)] ALIGN(BIT(seL4_PDPTBits));
 extern pde_t x64KSSKIMPD[BIT(PD_INDEX_BITS)] ALIGN(BIT(seL4_PageDirBits));
 #endif
 
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+#define SHOOTDOWN_QUEUE_SIZE 32
+
+/* a shootdown_type_t and its arguments */
+typedef struct shootdown {
+    word_t type;
+    word_t args[3];
+} shootdown_t;
+
+/* TLB invalidations for other cores that are queued during a kernel entry.
+ * The counters are kept for the lifetime of the kernel. */
+typedef struct shootdown_queue {
+    word_t count;
+    word_t mask;
+    /* number of remote calls the queued invalidations stand for */
+    word_t requests;
+    word_t ipisSent;
+    word_t ipisAvoided;
+    shootdown_t entries[SHOOTDOWN_QUEUE_SIZE];
+} shootdown_queue_t;
+#endif /* CONFIG_X86_DEFERRED_SHOOTDOWN */
+
 NODE_STATE_BEGIN(modeNodeState)
 #ifdef CONFIG_KERNEL_SKIM_WINDOW
 /* we declare this as a word_t and not a cr3_t as we cache both state and potentially
@@ -37,6 +59,9 @@ NODE_STATE_DECLARE(word_t, x64KSCurrentUserCR3);
 #else
 NODE_STATE_DECLARE(cr3_t, x64KSCurrentCR3);
 #endif
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+NODE_STATE_DECLARE(shootdown_queue_t, x64KSShootdowns);
+#endif
 NODE_STATE_END(modeNodeState);
 
 /* hardware interrupt handlers push up to 6 words onto the stack. The order of the
@@ -16,20 +16,67 @@
 typedef enum {
     IpiRemoteCall_InvalidatePCID = IpiNumArchRemoteCall,
     IpiRemoteCall_InvalidateASID,
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    IpiRemoteCall_InvalidatePCIDList,
+#endif
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    IpiRemoteCall_Shootdowns,
+#endif
     IpiNumModeRemoteCall
 } IpiModeRemoteCall_t;
 
 void Mode_handleRemoteCall(IpiModeRemoteCall_t call, word_t arg0, word_t arg1, word_t arg2);
 
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+typedef enum {
+    /* invalidateLocalPCID(type, vaddr, asid) */
+    shootdown_pcid,
+    /* invalidateLocalTranslationSingleASID(vptr, asid) */
+    shootdown_translation,
+    /* invalidateLocalASID(vspace, asid) */
+    shootdown_asid,
+    /* invalidateLocalPageStructureCacheASID(root, asid) */
+    shootdown_page_structure_cache
+} shootdown_type_t;
+
+/* Queue a TLB invalidation for the cores in mask. It is sent with all other
+ * queued invalidations by shootdownFlush, which is called before leaving the
+ * kernel or when the queue is full. Caller must hold the lock. */
+void shootdownQueue(word_t type, word_t arg0, word_t arg1, word_t arg2, word_t mask);
+void shootdownFlush(void);
+#endif
+
 static inline void doRemoteInvalidatePCID(word_t type, void *vaddr, asid_t asid, word_t mask)
 {
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    shootdownQueue(shootdown_pcid, type, (word_t)vaddr, asid, mask);
+#else
     doRemoteMaskOp3Arg((IpiRemoteCall_t)IpiRemoteCall_InvalidatePCID, type, (word_t)vaddr, asid, mask);
+#endif
 }
 
 static inline void doRemoteInvalidateASID(vspace_root_t *vspace, asid_t asid, word_t mask)
 {
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    shootdownQueue(shootdown_asid, (word_t)vspace, asid, 0, mask);
+#else
     doRemoteMaskOp2Arg((IpiRemoteCall_t)IpiRemoteCall_InvalidateASID, (word_t)vspace, asid, mask);
+#endif
+}
+
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+static inline void doRemoteInvalidatePCIDList(asid_t asid, word_t count, vptr_t *vptrs, word_t mask)
+{
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    /* the list lives on the stack of the caller, so it is queued by value */
+    for (word_t i = 0; i < count; i++) {
+        shootdownQueue(shootdown_translation, vptrs[i], asid, 0, mask);
+    }
+#else
+    doRemoteMaskOp3Arg((IpiRemoteCall_t)IpiRemoteCall_InvalidatePCIDList, asid, count, (word_t)vptrs, mask);
+#endif
 }
+#endif
 
 #endif /* ENABLE_SMP_SUPPORT */
 
@@ -21,6 +21,11 @@ NORETURN;
 void fastpath_call(word_t cptr, word_t r_msgInfo)
 NORETURN;
 
+#ifdef CONFIG_WAIT_FASTPATH
+void fastpath_wait(word_t cptr, syscall_t syscall)
+NORETURN;
+#endif
+
 #ifdef CONFIG_KERNEL_MCS
 void fastpath_reply_recv(word_t cptr, word_t r_msgInfo, word_t reply)
 #else
@@ -25,7 +25,13 @@ static inline void tlb_bitmap_init(vspace_root_t *root)
 static inline void tlb_bitmap_set(vspace_root_t *root, word_t cpu)
 {
     assert(cpu < TLBBITMAP_ROOT_BITS && cpu <= wordBits);
+#ifdef CONFIG_SMP_NODE_LOCKS
+    /* fastpaths on different cores may switch to the same vspace concurrently */
+    __atomic_fetch_or(&root[TLBBITMAP_ROOT_MAKE_INDEX(cpu)].words[0],
+                      TLBBITMAP_ROOT_MAKE_BIT(cpu), __ATOMIC_RELAXED);
+#else
     root[TLBBITMAP_ROOT_MAKE_INDEX(cpu)].words[0] |= TLBBITMAP_ROOT_MAKE_BIT(cpu);
+#endif
 }
 
 static inline void tlb_bitmap_unset(vspace_root_t *root, word_t cpu)
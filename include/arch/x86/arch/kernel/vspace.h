@@ -75,6 +75,9 @@ lookupPTSlot_ret_t lookupPTSlot(vspace_root_t *vspace, vptr_t vptr);
 lookupPDSlot_ret_t lookupPDSlot(vspace_root_t *vspace, vptr_t vptr);
 void copyGlobalMappings(vspace_root_t *new_vspace);
 word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread);
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap);
+#endif
 exception_t handleVMFault(tcb_t *thread, vm_fault_type_t vm_faultType);
 void unmapPageDirectory(asid_t asid, vptr_t vaddr, pde_t *pd);
 void unmapPageTable(asid_t, vptr_t vaddr, pte_t *pt);
@@ -82,6 +85,10 @@ void unmapPageTable(asid_t, vptr_t vaddr, pte_t *pt);
 exception_t performASIDPoolInvocation(asid_t asid, asid_pool_t *poolPtr, cte_t *vspaceCapSlot);
 exception_t performASIDControlInvocation(void *frame, cte_t *slot, cte_t *parent, asid_t asid_base);
 void hwASIDInvalidate(asid_t asid, vspace_root_t *vspace);
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+/* invalidates every translation of the address space, after many pages were unmapped */
+void modeInvalidateTranslationASID(vspace_root_t *vspace, asid_t asid);
+#endif
 void deleteASIDPool(asid_t asid_base, asid_pool_t *pool);
 void deleteASID(asid_t asid, vspace_root_t *vspace);
 findVSpaceForASID_ret_t findVSpaceForASID(asid_t asid);
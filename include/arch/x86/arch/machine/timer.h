@@ -76,6 +76,11 @@ static inline void resetTimer(void)
 {
     /* nothing to do */
 }
+
+#ifdef CONFIG_TICKLESS
+word_t getElapsedTicks(void);
+void setNextTick(word_t ticks);
+#endif
 #endif /* CONFIG_KERNEL_MCS */
 
 
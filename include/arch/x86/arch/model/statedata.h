@@ -48,6 +48,13 @@ NODE_STATE_DECLARE(word_t, x86KSCurrentGSBase);
  * back to NULL */
 NODE_STATE_DECLARE(word_t, x86KSGPExceptReturnTo);
 
+#ifdef CONFIG_TICKLESS
+/* APIC timer count last programmed, 0 if the timer is stopped, and the
+ * APIC cycles between the last tick accounted and the programming */
+NODE_STATE_DECLARE(uint32_t, x86KStimerCount);
+NODE_STATE_DECLARE(uint64_t, x86KStimerOffset);
+#endif
+
 NODE_STATE_TYPE_DECLARE(modeNodeState, mode);
 NODE_STATE_END(archNodeState);
 
@@ -92,4 +99,7 @@ extern word_t x86KSAllocatedIOPorts[NUM_IO_PORTS / CONFIG_WORD_SIZE];
 extern uint32_t x86KStscMhz;
 extern uint32_t x86KSapicRatio;
 #endif
+#ifdef CONFIG_TICKLESS
+extern uint32_t x86KSapicTickCycles;
+#endif
 
@@ -21,6 +21,14 @@ enum tcb_arch_cnode_index {
 #ifdef CONFIG_VTX
     /* VSpace root for running any associated VCPU in */
     tcbArchEPTRoot = tcbCNodeEntries,
+#ifdef CONFIG_MESSAGE_WINDOW
+    /* Frame mapped at the thread's message window */
+    tcbArchMsgWindow,
+#endif
+    tcbArchCNodeEntries
+#elif defined(CONFIG_MESSAGE_WINDOW)
+    /* Frame mapped at the thread's message window */
+    tcbArchMsgWindow = tcbCNodeEntries,
     tcbArchCNodeEntries
 #else
     tcbArchCNodeEntries = tcbCNodeEntries
@@ -34,6 +42,10 @@ typedef struct arch_tcb {
      * tcb->tcbVCPU->vcpuTCB == tcb. */
     struct vcpu *tcbVCPU;
 #endif /* CONFIG_VTX */
+#ifdef CONFIG_MESSAGE_WINDOW
+    /* Virtual address of the message window, 0 if the thread has none */
+    word_t tcbMsgWindowAddr;
+#endif
 } arch_tcb_t;
 
 #define SEL_NULL    GDT_NULL
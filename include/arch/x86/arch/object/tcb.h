@@ -14,3 +14,9 @@
 exception_t decodeSetEPTRoot(cap_t cap);
 void Arch_leaveVMAsyncTransfer(tcb_t *tcb);
 #endif
+
+#ifdef CONFIG_MESSAGE_WINDOW
+exception_t decodeSetMessageWindow(cap_t cap, word_t length, word_t *buffer);
+exception_t decodeTakeMessageWindow(cap_t cap, word_t length, word_t *buffer);
+void Arch_transferMessageWindow(tcb_t *sender, tcb_t *receiver);
+#endif
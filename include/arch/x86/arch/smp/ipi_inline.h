@@ -8,6 +8,9 @@
 
 #include <config.h>
 #include <smp/ipi.h>
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+#include <mode/smp/ipi.h>
+#endif
 
 #ifdef ENABLE_SMP_SUPPORT
 static inline void doRemoteStall(word_t cpu)
@@ -22,7 +25,11 @@ static inline void doRemoteswitchFpuOwner(user_fpu_state_t *new_owner, word_t cp
 
 static inline void doRemoteInvalidatePageStructureCacheASID(paddr_t root, asid_t asid, word_t mask)
 {
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    shootdownQueue(shootdown_page_structure_cache, root, asid, 0, mask);
+#else
     doRemoteMaskOp2Arg(IpiRemoteCall_InvalidatePageStructureCacheASID, root, asid, mask);
+#endif
 }
 
 static inline void doRemoteInvalidateTranslationSingle(vptr_t vptr, word_t mask)
@@ -32,7 +39,11 @@ static inline void doRemoteInvalidateTranslationSingle(vptr_t vptr, word_t mask)
 
 static inline void doRemoteInvalidateTranslationSingleASID(vptr_t vptr, asid_t asid, word_t mask)
 {
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    shootdownQueue(shootdown_translation, vptr, asid, 0, mask);
+#else
     doRemoteMaskOp2Arg(IpiRemoteCall_InvalidateTranslationSingleASID, vptr, asid, mask);
+#endif
 }
 
 static inline void doRemoteInvalidateTranslationAll(word_t mask)
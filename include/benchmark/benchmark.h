@@ -13,6 +13,7 @@
 #include <arch/machine/hardware.h>
 #include <sel4/benchmark_tracepoints_types.h>
 #include <mode/hardware.h>
+#include <model/statedata.h>
 
 #ifdef CONFIG_ENABLE_BENCHMARKS
 exception_t handle_SysBenchmarkFlushCaches(void);
@@ -29,6 +30,9 @@ exception_t handle_SysBenchmarkDumpAllThreadsUtilisation(void);
 exception_t handle_SysBenchmarkResetAllThreadsUtilisation(void);
 #endif /* CONFIG_DEBUG_BUILD */
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+exception_t handle_SysBenchmarkGetEntryHistogram(void);
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
 #endif /* CONFIG_ENABLE_BENCHMARKS */
 
 #if CONFIG_MAX_NUM_TRACE_POINTS > 0
@@ -50,6 +54,46 @@ static inline void trace_point_start(word_t id)
     ksStarted[id] = true;
 }
 
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+compile_assert(tracepoint_ring_not_empty, seL4_TracepointRingEntries > 0)
+
+static inline benchmark_tracepoint_ring_t *tracepoint_ring(word_t core)
+{
+    return (benchmark_tracepoint_ring_t *)(KS_LOG_PPTR + core * seL4_TracepointRingBytes);
+}
+
+/* Empty the tracepoint rings of all cores */
+static inline void tracepoint_rings_reset(void)
+{
+    for (word_t core = 0; core < CONFIG_MAX_NUM_NODES; core++) {
+        NODE_STATE_ON_CORE(benchmark_tracepoint_head, core) = 0;
+        tracepoint_ring(core)->head = 0;
+        tracepoint_ring(core)->finalized = 0;
+    }
+}
+
+static inline void trace_point_stop(word_t id)
+{
+    ksExit = timestamp();
+
+    if (likely(ksUserLogBuffer != 0)) {
+        if (likely(ksStarted[id])) {
+            benchmark_tracepoint_ring_t *ring = tracepoint_ring(CURRENT_CPU_INDEX());
+            word_t head = NODE_STATE(benchmark_tracepoint_head);
+
+            ksStarted[id] = false;
+            /* The head in the log buffer can be written by user level, so
+             * the kernel only ever uses its own copy. */
+            ring->entries[head % seL4_TracepointRingEntries] = (benchmark_tracepoint_log_entry_t) {
+                id, ksExit - ksEntries[id]
+            };
+            head++;
+            NODE_STATE(benchmark_tracepoint_head) = head;
+            __atomic_store_n(&ring->head, head, __ATOMIC_RELEASE);
+        }
+    }
+}
+#else
 static inline void trace_point_stop(word_t id)
 {
     benchmark_tracepoint_log_entry_t *ksLog = (benchmark_tracepoint_log_entry_t *) KS_LOG_PPTR;
@@ -71,6 +115,7 @@ static inline void trace_point_stop(word_t id)
         assert(ksLogIndex > 0);
     }
 }
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
 
 #else
 
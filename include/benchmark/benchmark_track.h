@@ -19,6 +19,7 @@
 #define TRACK_KERNEL_ENTRIES 1
 extern kernel_entry_t ksKernelEntry;
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
+#ifdef CONFIG_KERNEL_LOG_BUFFER
 /**
  *  Calculate the maximum number of kernel entries that can be tracked,
  *  limited by the log buffer size. This is also the number of ksLog entries.
@@ -27,9 +28,11 @@ extern kernel_entry_t ksKernelEntry;
 #define MAX_LOG_SIZE (seL4_LogBufferSize / \
              sizeof(benchmark_track_kernel_entry_t))
 
-extern timestamp_t ksEnter;
 extern seL4_Word ksLogIndex;
 extern seL4_Word ksLogIndexFinalized;
+#endif /* CONFIG_KERNEL_LOG_BUFFER */
+
+extern timestamp_t ksEnter;
 
 /**
  * @brief Fill in logging info for kernel entries
@@ -37,6 +40,14 @@ extern seL4_Word ksLogIndexFinalized;
  */
 void benchmark_track_exit(void);
 
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+/**
+ * @brief Clear the kernel entry histograms of all cores
+ *
+ */
+void benchmark_entry_histograms_reset(void);
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
+
 /**
  * @brief Start logging kernel entries
  *
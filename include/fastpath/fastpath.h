@@ -10,6 +10,9 @@
 #include <object/reply.h>
 #include <object/notification.h>
 #endif
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+#include <kernel/cspace.h>
+#endif
 
 #ifdef CONFIG_SIGNAL_FASTPATH
 /* Equivalent to schedContext_donate without migrateTCB() */
@@ -90,6 +93,14 @@ static inline cap_t FORCE_INLINE lookup_fp(cap_t cap, cptr_t cptr)
     cte_t *slot;
     word_t guardBits, radixBits, bits;
     word_t radix, capGuard;
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    cap_t root = cap;
+
+    slot = cspaceCacheLookup(root, cptr);
+    if (likely(slot != NULL)) {
+        return slot->cap;
+    }
+#endif
 
     bits = 0;
 
@@ -126,8 +137,228 @@ static inline cap_t FORCE_INLINE lookup_fp(cap_t cap, cptr_t cptr)
         return cap_null_cap_new();
     }
 
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    cspaceCacheInsert(root, cptr, slot);
+#endif
     return cap;
 }
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+#define FASTPATH_MAX_MSG_LENGTH CONFIG_FASTPATH_MAX_MSG_LENGTH
+compile_assert(fastpath_max_msg_length_valid,
+               FASTPATH_MAX_MSG_LENGTH > n_msgRegisters && FASTPATH_MAX_MSG_LENGTH <= seL4_MsgMaxLength)
+#else
+#define FASTPATH_MAX_MSG_LENGTH n_msgRegisters
+#endif
+
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+#define FASTPATH_MAX_EXTRA_CAPS 1
+#else
+#define FASTPATH_MAX_EXTRA_CAPS 0
+#endif
+
+#if defined(CONFIG_FASTPATH_EXTRA_CAP) || defined(CONFIG_FASTPATH_LONG_MESSAGES)
+/* Like fastpath_mi_check, but also accepts the longer messages and the
+   single extra cap that the enabled fastpath extensions handle. */
+static inline int fastpath_mi_check_ext(word_t msgInfo)
+{
+    seL4_MessageInfo_t info = messageInfoFromWord_raw(msgInfo);
+
+    return seL4_MessageInfo_get_length(info) > FASTPATH_MAX_MSG_LENGTH ||
+           seL4_MessageInfo_get_extraCaps(info) > FASTPATH_MAX_EXTRA_CAPS;
+}
+#endif
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+/* Looks up the IPC buffers that a message longer than the message registers
+   is copied between. The slowpath silently truncates such a message if
+   either buffer is missing, so leave that case to it. */
+static inline bool_t FORCE_INLINE fastpath_long_msg_check(tcb_t *sender, tcb_t *receiver,
+                                                          word_t **sendBuffer,
+                                                          word_t **recvBuffer)
+{
+    *sendBuffer = lookupIPCBuffer(false, sender);
+    *recvBuffer = lookupIPCBuffer(true, receiver);
+
+    return *sendBuffer != NULL && *recvBuffer != NULL;
+}
+
+/* Copies the message words that do not fit in the message registers */
+static inline void FORCE_INLINE fastpath_copy_long_msg(word_t length, word_t *sendBuffer,
+                                                       word_t *recvBuffer)
+{
+    copyIPCBufferWords(&recvBuffer[n_msgRegisters + 1], &sendBuffer[n_msgRegisters + 1],
+                       length - n_msgRegisters);
+}
+#endif
+
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+
+/* Fastpath slot lookup, equivalent to lookupSlot. Same algorithm as
+   lookup_fp, but returns the slot rather than the cap. Returns NULL on
+   failure. */
+static inline cte_t *FORCE_INLINE lookup_slot_fp(cap_t cap, cptr_t cptr)
+{
+    word_t cptr2;
+    cte_t *slot;
+    word_t guardBits, radixBits, bits;
+    word_t radix, capGuard;
+
+    bits = 0;
+
+    if (unlikely(! cap_capType_equals(cap, cap_cnode_cap))) {
+        return NULL;
+    }
+
+    do {
+        guardBits = cap_cnode_cap_get_capCNodeGuardSize(cap);
+        radixBits = cap_cnode_cap_get_capCNodeRadix(cap);
+        cptr2 = cptr << bits;
+
+        capGuard = cap_cnode_cap_get_capCNodeGuard(cap);
+
+        if (likely(guardBits) && unlikely(cptr2 >> (wordBits - guardBits) != capGuard)) {
+            return NULL;
+        }
+
+        radix = cptr2 << guardBits >> (wordBits - radixBits);
+        slot = CTE_PTR(cap_cnode_cap_get_capCNodePtr(cap)) + radix;
+
+        cap = slot->cap;
+        bits += guardBits + radixBits;
+
+    } while (unlikely(bits < wordBits && cap_capType_equals(cap, cap_cnode_cap)));
+
+    if (unlikely(bits > wordBits)) {
+        return NULL;
+    }
+
+    return slot;
+}
+
+/* Fastpath equivalent of lookupTargetSlot: resolves exactly depth bits of
+   cptr starting from the CNode cap. Returns NULL wherever the slowpath
+   would report a lookup failure. */
+static inline cte_t *FORCE_INLINE lookup_target_slot_fp(cap_t cap, cptr_t cptr, word_t depth)
+{
+    word_t radixBits, guardBits, levelBits, guard;
+    word_t capGuard, offset;
+    cte_t *slot;
+
+    if (unlikely(!cap_capType_equals(cap, cap_cnode_cap) ||
+                 depth < 1 || depth > wordBits)) {
+        return NULL;
+    }
+
+    while (1) {
+        radixBits = cap_cnode_cap_get_capCNodeRadix(cap);
+        guardBits = cap_cnode_cap_get_capCNodeGuardSize(cap);
+        levelBits = radixBits + guardBits;
+        capGuard = cap_cnode_cap_get_capCNodeGuard(cap);
+
+        guard = (cptr >> ((depth - guardBits) & MASK(wordRadix))) & MASK(guardBits);
+        if (unlikely(levelBits == 0 || levelBits > depth || guard != capGuard)) {
+            return NULL;
+        }
+
+        offset = (cptr >> (depth - levelBits)) & MASK(radixBits);
+        slot = CTE_PTR(cap_cnode_cap_get_capCNodePtr(cap)) + offset;
+
+        if (likely(depth == levelBits)) {
+            return slot;
+        }
+
+        depth -= levelBits;
+        cap = slot->cap;
+
+        if (unlikely(!cap_capType_equals(cap, cap_cnode_cap))) {
+            /* bits remaining, which lookupTargetSlot rejects */
+            return NULL;
+        }
+    }
+}
+
+/* Checks whether the single extra cap of a message from sender to receiver
+   over ep_ptr (NULL for a reply) can be transferred on the fastpath. Only
+   endpoint caps are handled: they are either unwrapped into a badge when
+   they refer to ep_ptr, or copied into the receiver's receive slot, which
+   for an endpoint cap needs neither deriveCap nor a revocable MDB entry.
+   On success *srcSlot and *recvBuffer are set, and *destSlot is the
+   receiver's empty receive slot, or NULL if the cap is unwrapped. Returns
+   false if the transfer must be left to the slowpath. */
+static inline bool_t FORCE_INLINE fastpath_extra_cap_check(tcb_t *sender, tcb_t *receiver,
+                                                           endpoint_t *ep_ptr, cte_t **srcSlot,
+                                                           cte_t **destSlot, word_t **recvBuffer)
+{
+    word_t *sendBuffer;
+    cap_transfer_t ct;
+    cap_t cap;
+
+    sendBuffer = lookupIPCBuffer(false, sender);
+    *recvBuffer = lookupIPCBuffer(true, receiver);
+    if (unlikely(!sendBuffer || !*recvBuffer)) {
+        return false;
+    }
+
+    *srcSlot = lookup_slot_fp(TCB_PTR_CTE_PTR(sender, tcbCTable)->cap,
+                              getExtraCPtr(sendBuffer, 0));
+    if (unlikely(*srcSlot == NULL)) {
+        return false;
+    }
+
+    cap = (*srcSlot)->cap;
+    if (unlikely(!cap_capType_equals(cap, cap_endpoint_cap))) {
+        return false;
+    }
+
+    if (EP_PTR(cap_endpoint_cap_get_capEPPtr(cap)) == ep_ptr) {
+        *destSlot = NULL;
+        return true;
+    }
+
+    ct = loadCapTransfer(*recvBuffer);
+    *destSlot = lookup_target_slot_fp(
+                    lookup_fp(TCB_PTR_CTE_PTR(receiver, tcbCTable)->cap, ct.ctReceiveRoot),
+                    ct.ctReceiveIndex, ct.ctReceiveDepth);
+    if (unlikely(*destSlot == NULL ||
+                 !cap_capType_equals((*destSlot)->cap, cap_null_cap))) {
+        return false;
+    }
+
+    return true;
+}
+
+/* Performs a transfer validated by fastpath_extra_cap_check and returns the
+   updated message info for the receiver. This is cteInsert specialised to
+   an unbadged copy of an endpoint cap, which is never revocable. */
+static inline seL4_MessageInfo_t FORCE_INLINE fastpath_extra_cap_transfer(seL4_MessageInfo_t info,
+                                                                          cte_t *srcSlot, cte_t *destSlot,
+                                                                          word_t *recvBuffer)
+{
+    mdb_node_t newMDB;
+    cap_t cap = srcSlot->cap;
+
+    if (destSlot == NULL) {
+        setExtraBadge(recvBuffer, cap_endpoint_cap_get_capEPBadge(cap), 0);
+        return seL4_MessageInfo_set_capsUnwrapped(info, 1);
+    }
+
+    newMDB = mdb_node_set_mdbPrev(srcSlot->cteMDBNode, CTE_REF(srcSlot));
+    newMDB = mdb_node_set_mdbRevocable(newMDB, false);
+    newMDB = mdb_node_set_mdbFirstBadged(newMDB, false);
+
+    destSlot->cap = cap;
+    destSlot->cteMDBNode = newMDB;
+    mdb_node_ptr_set_mdbNext(&srcSlot->cteMDBNode, CTE_REF(destSlot));
+    if (mdb_node_get_mdbNext(newMDB)) {
+        mdb_node_ptr_set_mdbPrev(&CTE_PTR(mdb_node_get_mdbNext(newMDB))->cteMDBNode,
+                                 CTE_REF(destSlot));
+    }
+
+    return seL4_MessageInfo_set_capsUnwrapped(info, 0);
+}
+#endif /* CONFIG_FASTPATH_EXTRA_CAP */
+
 /* make sure the fastpath functions conform with structure_*.bf */
 static inline void thread_state_ptr_set_tsType_np(thread_state_t *ts_ptr, word_t tsType)
 {
@@ -167,6 +398,29 @@ static inline void endpoint_ptr_set_epQueue_head_np(endpoint_t *ep_ptr, word_t e
     ep_ptr->words[1] = epQueue_head;
 }
 
+#ifdef CONFIG_WAIT_FASTPATH
+#ifdef CONFIG_VERIFICATION_BUILD
+#error "The wait fastpath uses multi-field bitfield accessors, which verification builds do not generate"
+#endif
+
+/* Block the current thread on a notification, as receiveSignal does */
+static inline void ntfn_queue_append_fp(tcb_t *thread, notification_t *ntfn_ptr)
+{
+    tcb_queue_t ntfn_queue;
+
+    thread_state_ptr_mset_blockingObject_tsType(&thread->tcbState, NTFN_REF(ntfn_ptr),
+                                                ThreadState_BlockedOnNotification);
+
+    ntfn_queue.head = (tcb_t *)notification_ptr_get_ntfnQueue_head(ntfn_ptr);
+    ntfn_queue.end = (tcb_t *)notification_ptr_get_ntfnQueue_tail(ntfn_ptr);
+
+    ntfn_queue = tcbEPAppend(thread, ntfn_queue);
+
+    notification_ptr_set_ntfnQueue_head(ntfn_ptr, (word_t)ntfn_queue.head);
+    notification_ptr_mset_ntfnQueue_tail_state(ntfn_ptr, (word_t)ntfn_queue.end, NtfnState_Waiting);
+}
+#endif
+
 #ifdef CONFIG_KERNEL_MCS
 static inline void thread_state_ptr_set_replyObject_np(thread_state_t *ts_ptr, word_t reply)
 {
@@ -10,6 +10,9 @@
 #include <api/failures.h>
 #include <api/types.h>
 #include <object/structures.h>
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+#include <model/statedata.h>
+#endif
 
 struct lookupCap_ret {
     exception_t status;
@@ -59,3 +62,42 @@ resolveAddressBits_ret_t resolveAddressBits(cap_t nodeCap,
                                             cptr_t capptr,
                                             word_t n_bits);
 
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+static inline cspace_cache_entry_t *cspaceCacheEntry(cptr_t cptr)
+{
+    /* The lowest bits of a cptr index the last CNode level */
+    return &NODE_STATE(ksCSpaceCache)[cptr & MASK(CSPACE_LOOKUP_CACHE_BITS)];
+}
+
+/* Returns the slot that cptr resolved to in the CSpace of root, or NULL if
+ * there is no valid cached lookup. */
+static inline cte_t *cspaceCacheLookup(cap_t root, cptr_t cptr)
+{
+    cspace_cache_entry_t *entry = cspaceCacheEntry(cptr);
+
+    if (likely(entry->generation == ksCSpaceGeneration && entry->cptr == cptr &&
+               entry->root.words[0] == root.words[0] && entry->root.words[1] == root.words[1])) {
+        return entry->slot;
+    }
+    return NULL;
+}
+
+static inline void cspaceCacheInsert(cap_t root, cptr_t cptr, cte_t *slot)
+{
+    cspace_cache_entry_t *entry = cspaceCacheEntry(cptr);
+
+    entry->root = root;
+    entry->cptr = cptr;
+    entry->slot = slot;
+    entry->generation = ksCSpaceGeneration;
+}
+
+/* Cached lookups only depend on the CNode caps along the path, so they are
+ * only invalidated when a CNode cap is written to or removed from a slot. */
+static inline void cspaceCacheCapChanged(cap_t oldCap, cap_t newCap)
+{
+    if (cap_get_capType(oldCap) == cap_cnode_cap || cap_get_capType(newCap) == cap_cnode_cap) {
+        ksCSpaceGeneration++;
+    }
+}
+#endif
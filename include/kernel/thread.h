@@ -26,6 +26,31 @@ static inline CONST word_t ready_queues_index(word_t dom, word_t prio)
     }
 }
 
+/* Ready queue state of a core. The queue and the bitmap words of a domain are
+ * lvalues, so they can be assigned through these. */
+#ifdef CONFIG_PACKED_READY_QUEUES
+#define READY_QUEUE_ON_CORE(_dom, _prio, _core) \
+    NODE_STATE_ON_CORE(ksDomainReadyQueues[(_dom)], _core).queues[(_prio)]
+#define READY_QUEUES_L1_BITMAP_ON_CORE(_dom, _core) \
+    NODE_STATE_ON_CORE(ksDomainReadyQueues[(_dom)], _core).l1Bitmap
+#define READY_QUEUES_L2_BITMAP_ON_CORE(_dom, _l1index_inverted, _core) \
+    NODE_STATE_ON_CORE(ksDomainReadyQueues[(_dom)], _core).l2Bitmap[(_l1index_inverted)]
+#else
+#define READY_QUEUE_ON_CORE(_dom, _prio, _core) \
+    NODE_STATE_ON_CORE(ksReadyQueues[ready_queues_index(_dom, _prio)], _core)
+#define READY_QUEUES_L1_BITMAP_ON_CORE(_dom, _core) \
+    NODE_STATE_ON_CORE(ksReadyQueuesL1Bitmap[(_dom)], _core)
+#define READY_QUEUES_L2_BITMAP_ON_CORE(_dom, _l1index_inverted, _core) \
+    NODE_STATE_ON_CORE(ksReadyQueuesL2Bitmap[(_dom)][(_l1index_inverted)], _core)
+#endif
+
+#define READY_QUEUE(_dom, _prio) \
+    READY_QUEUE_ON_CORE(_dom, _prio, CURRENT_CPU_INDEX())
+#define READY_QUEUES_L1_BITMAP(_dom) \
+    READY_QUEUES_L1_BITMAP_ON_CORE(_dom, CURRENT_CPU_INDEX())
+#define READY_QUEUES_L2_BITMAP(_dom, _l1index_inverted) \
+    READY_QUEUES_L2_BITMAP_ON_CORE(_dom, _l1index_inverted, CURRENT_CPU_INDEX())
+
 static inline CONST word_t prio_to_l1index(word_t prio)
 {
     return (prio >> wordRadix);
@@ -65,18 +90,18 @@ static inline prio_t getHighestPrio(word_t dom)
     word_t l1index_inverted;
 
     /* it's undefined to call clzl on 0 */
-    assert(NODE_STATE(ksReadyQueuesL1Bitmap)[dom] != 0);
+    assert(READY_QUEUES_L1_BITMAP(dom) != 0);
 
-    l1index = wordBits - 1 - clzl(NODE_STATE(ksReadyQueuesL1Bitmap)[dom]);
+    l1index = wordBits - 1 - clzl(READY_QUEUES_L1_BITMAP(dom));
     l1index_inverted = invert_l1index(l1index);
-    assert(NODE_STATE(ksReadyQueuesL2Bitmap)[dom][l1index_inverted] != 0);
-    l2index = wordBits - 1 - clzl(NODE_STATE(ksReadyQueuesL2Bitmap)[dom][l1index_inverted]);
+    assert(READY_QUEUES_L2_BITMAP(dom, l1index_inverted) != 0);
+    l2index = wordBits - 1 - clzl(READY_QUEUES_L2_BITMAP(dom, l1index_inverted));
     return (l1index_to_prio(l1index) | l2index);
 }
 
 static inline bool_t isHighestPrio(word_t dom, prio_t prio)
 {
-    return NODE_STATE(ksReadyQueuesL1Bitmap)[dom] == 0 ||
+    return READY_QUEUES_L1_BITMAP(dom) == 0 ||
            prio >= getHighestPrio(dom);
 }
 
@@ -118,7 +143,7 @@ static inline bool_t PURE isRoundRobin(sched_context_t *sc)
 static inline bool_t isCurDomainExpired(void)
 {
     return numDomains > 1 &&
-           ksDomainTime == 0;
+           DOM_STATE(ksDomainTime) == 0;
 }
 
 static inline void commitTime(void)
@@ -190,6 +215,11 @@ void chooseThread(void);
 void switchToThread(tcb_t *thread);
 void switchToIdleThread(void);
 void setDomain(tcb_t *tptr, dom_t dom);
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+void setDomainScheduleEntry(word_t core, word_t index, dom_t domain, word_t length);
+bool_t isDomainScheduleConfigured(word_t core, word_t length);
+void commitDomainSchedule(word_t core, word_t length);
+#endif
 void setPriority(tcb_t *tptr, prio_t prio);
 void setMCPriority(tcb_t *tptr, prio_t mcp);
 void scheduleTCB(tcb_t *tptr);
@@ -236,10 +266,10 @@ static inline void updateTimestamp(void)
     ticks_t consumed = (NODE_STATE(ksCurTime) - prev);
     NODE_STATE(ksConsumed) += consumed;
     if (numDomains > 1) {
-        if ((consumed + MIN_BUDGET) >= ksDomainTime) {
-            ksDomainTime = 0;
+        if ((consumed + MIN_BUDGET) >= DOM_STATE(ksDomainTime)) {
+            DOM_STATE(ksDomainTime) = 0;
         } else {
-            ksDomainTime -= consumed;
+            DOM_STATE(ksDomainTime) -= consumed;
         }
     }
 
@@ -24,6 +24,19 @@ void switchLocalFpuOwner(user_fpu_state_t *new_owner);
 /* Switch the current owner of the FPU state on the core specified by 'cpu'. */
 void switchFpuOwner(user_fpu_state_t *new_owner, word_t cpu);
 
+#ifdef CONFIG_FPU_EAGER_SWITCH
+/* After this many eager restores the usage count of a thread wraps to zero
+ * and it goes back to lazy switching, so that a thread that has stopped
+ * using the FPU only pays for a bounded number of eager restores. */
+#define FPU_EAGER_REPROBE_PERIOD 256
+
+compile_assert(fpu_eager_threshold_sane,
+               CONFIG_FPU_EAGER_THRESHOLD > 0 && CONFIG_FPU_EAGER_THRESHOLD < FPU_EAGER_REPROBE_PERIOD)
+
+/* Load the FPU state of the given thread without waiting for it to fault. */
+void eagerFPURestore(tcb_t *thread);
+#endif
+
 /* Returns whether or not the passed thread is using the current active fpu state */
 static inline bool_t nativeThreadUsingFPU(tcb_t *thread)
 {
@@ -33,6 +46,15 @@ static inline bool_t nativeThreadUsingFPU(tcb_t *thread)
 
 static inline void FORCE_INLINE lazyFPURestore(tcb_t *thread)
 {
+#ifdef CONFIG_FPU_EAGER_SWITCH
+    /* Threads that keep faulting on their first FPU use get their state
+     * loaded up front, which avoids the fault. */
+    if (unlikely(thread->tcbFPUUsage >= CONFIG_FPU_EAGER_THRESHOLD) &&
+        !nativeThreadUsingFPU(thread)) {
+        eagerFPURestore(thread);
+        return;
+    }
+#endif
     if (unlikely(NODE_STATE(ksActiveFPUState))) {
         /* If we have enabled/disabled the FPU too many times without
          * someone else trying to use it, we assume it is no longer
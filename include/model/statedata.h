@@ -11,6 +11,7 @@
 #include <object/structures.h>
 #include <object/tcb.h>
 #include <mode/types.h>
+#include <sel4/benchmark_track_types.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 #define NODE_STATE_BEGIN(_name)                 typedef struct _name {
@@ -55,10 +56,37 @@
 #define NUM_READY_QUEUES (CONFIG_NUM_DOMAINS * CONFIG_NUM_PRIORITIES)
 #define L2_BITMAP_SIZE ((CONFIG_NUM_PRIORITIES + wordBits - 1) / wordBits)
 
+#ifdef CONFIG_PACKED_READY_QUEUES
+/* All ready queue state of one domain. The bitmaps share the first cache line,
+ * so choosing a thread touches that line and the line of the queue head. */
+typedef struct ready_queues {
+    word_t l1Bitmap;
+    word_t l2Bitmap[L2_BITMAP_SIZE];
+    tcb_queue_t queues[CONFIG_NUM_PRIORITIES];
+} ALIGN(L1_CACHE_LINE_SIZE) ready_queues_t;
+#endif
+
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+#define CSPACE_LOOKUP_CACHE_BITS 3
+
+/* A resolved full-depth lookup of cptr in the CSpace with root cap root. The
+ * entry is only valid while generation matches ksCSpaceGeneration. */
+typedef struct cspace_cache_entry {
+    cap_t root;
+    cptr_t cptr;
+    cte_t *slot;
+    uint64_t generation;
+} cspace_cache_entry_t;
+#endif
+
 NODE_STATE_BEGIN(nodeState)
+#ifdef CONFIG_PACKED_READY_QUEUES
+NODE_STATE_DECLARE(ready_queues_t, ksDomainReadyQueues[CONFIG_NUM_DOMAINS]);
+#else
 NODE_STATE_DECLARE(tcb_queue_t, ksReadyQueues[NUM_READY_QUEUES]);
 NODE_STATE_DECLARE(word_t, ksReadyQueuesL1Bitmap[CONFIG_NUM_DOMAINS]);
 NODE_STATE_DECLARE(word_t, ksReadyQueuesL2Bitmap[CONFIG_NUM_DOMAINS][L2_BITMAP_SIZE]);
+#endif
 NODE_STATE_DECLARE(tcb_t, *ksCurThread);
 NODE_STATE_DECLARE(tcb_t, *ksIdleThread);
 NODE_STATE_DECLARE(tcb_t, *ksSchedulerAction);
@@ -70,6 +98,17 @@ NODE_STATE_DECLARE(ticks_t, ksCurTime);
 NODE_STATE_DECLARE(bool_t, ksReprogram);
 NODE_STATE_DECLARE(sched_context_t, *ksCurSC);
 NODE_STATE_DECLARE(sched_context_t, *ksIdleSC);
+#ifdef CONFIG_RELEASE_QUEUE_HEAP
+NODE_STATE_DECLARE(word_t, ksReleaseQueueSize);
+#endif
+#endif
+#ifdef CONFIG_IRQ_RATE_LIMIT
+/* Number of rate limited IRQs waiting for this core's timer, and the
+ * earliest time one of them is due */
+NODE_STATE_DECLARE(word_t, ksIRQDeferred);
+NODE_STATE_DECLARE(ticks_t, ksIRQDeferredDeadline);
+/* Number of interrupts this core folded into a later delivery */
+NODE_STATE_DECLARE(word_t, ksIRQSuppressed);
 #endif
 
 #ifdef CONFIG_HAVE_FPU
@@ -89,6 +128,36 @@ NODE_STATE_DECLARE(timestamp_t, benchmark_kernel_time);
 NODE_STATE_DECLARE(timestamp_t, benchmark_kernel_number_entries);
 NODE_STATE_DECLARE(timestamp_t, benchmark_kernel_number_schedules);
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+/* Number of entries written to this core's tracepoint ring */
+NODE_STATE_DECLARE(word_t, benchmark_tracepoint_head);
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+/* Kernel entry histograms, the last one counts entries without a free histogram */
+NODE_STATE_DECLARE(benchmark_entry_histogram_t, benchmark_entry_histograms[seL4_BenchmarkEntryHistograms + 1]);
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+NODE_STATE_DECLARE(cspace_cache_entry_t, ksCSpaceCache[BIT(CSPACE_LOOKUP_CACHE_BITS)]);
+#endif
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* Each core steps through its own domain schedule. One of the two schedules
+ * is active, the other is the one user level configures */
+NODE_STATE_DECLARE(dschedule_t, ksDomSchedules[2][CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH]);
+NODE_STATE_DECLARE(word_t, ksDomScheduleLengths[2]);
+NODE_STATE_DECLARE(word_t, ksDomScheduleActive);
+/* Whether the other schedule is to become active at the end of this one */
+NODE_STATE_DECLARE(bool_t, ksDomSchedulePending);
+/* Entries of the inactive schedule written since it was last swapped out */
+#define DOM_SCHEDULE_BITMAP_SIZE ((CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH + wordBits - 1) / wordBits)
+NODE_STATE_DECLARE(word_t, ksDomScheduleWritten[DOM_SCHEDULE_BITMAP_SIZE]);
+NODE_STATE_DECLARE(word_t, ksDomScheduleIdx);
+NODE_STATE_DECLARE(dom_t, ksCurDomain);
+#ifdef CONFIG_KERNEL_MCS
+NODE_STATE_DECLARE(ticks_t, ksDomainTime);
+#else
+NODE_STATE_DECLARE(word_t, ksDomainTime);
+#endif
+#endif
 
 NODE_STATE_END(nodeState);
 
@@ -100,11 +169,22 @@ extern word_t ksNumCPUs;
 #define INT_STATE_ARRAY_SIZE (maxIRQ + 1)
 #endif
 extern word_t ksWorkUnitsCompleted;
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+extern uint64_t ksCSpaceGeneration;
+#endif
 extern irq_state_t intStateIRQTable[];
+#ifdef CONFIG_IRQ_RATE_LIMIT
+extern irq_rate_limit_t intStateIRQRateLimit[];
+#endif
 extern cte_t intStateIRQNode[];
 
 extern const dschedule_t ksDomSchedule[];
 extern const word_t ksDomScheduleLength;
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* The domain state is per core, ksDomSchedule is only the boot schedule */
+#define DOM_STATE(_state)                       NODE_STATE(_state)
+#define DOM_STATE_ON_CORE(_state, _core)        NODE_STATE_ON_CORE(_state, _core)
+#else
 extern word_t ksDomScheduleIdx;
 extern dom_t ksCurDomain;
 #ifdef CONFIG_KERNEL_MCS
@@ -112,6 +192,9 @@ extern ticks_t ksDomainTime;
 #else
 extern word_t ksDomainTime;
 #endif
+#define DOM_STATE(_state)                       _state
+#define DOM_STATE_ON_CORE(_state, _core)        _state
+#endif
 extern word_t tlbLockCount VISIBLE;
 
 extern char ksIdleThreadTCB[CONFIG_MAX_NUM_NODES][BIT(seL4_TCBBits)];
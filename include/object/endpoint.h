@@ -25,6 +25,27 @@ static inline void ep_ptr_set_queue(endpoint_t *epptr, tcb_queue_t queue)
     endpoint_ptr_set_epQueue_tail(epptr, (word_t)queue.end);
 }
 
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+/* Drop the cancelBadgedSends cursor recorded by owner, if any */
+static inline void clearCancelCursor(tcb_t *owner)
+{
+    if (owner->tcbCancelCursor) {
+        owner->tcbCancelCursor->tcbCancelOwner = NULL;
+        owner->tcbCancelCursor = NULL;
+    }
+}
+
+/* Called whenever a thread leaves an endpoint queue, so that no cursor is
+ * left pointing at a thread that is no longer in the queue it was found in */
+static inline void releaseCancelCursor(tcb_t *thread)
+{
+    if (unlikely(thread->tcbCancelOwner)) {
+        thread->tcbCancelOwner->tcbCancelCursor = NULL;
+        thread->tcbCancelOwner = NULL;
+    }
+}
+#endif
+
 #ifdef CONFIG_KERNEL_MCS
 void sendIPC(bool_t blocking, bool_t do_call, word_t badge,
              bool_t canGrant, bool_t canGrantReply, bool_t canDonate, tcb_t *thread,
@@ -39,7 +60,11 @@ void receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking);
 #endif
 void cancelIPC(tcb_t *tptr);
 void cancelAllIPC(endpoint_t *epptr);
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+exception_t cancelBadgedSends(endpoint_t *epptr, word_t badge);
+#else
 void cancelBadgedSends(endpoint_t *epptr, word_t badge);
+#endif
 void replyFromKernel_error(tcb_t *thread);
 void replyFromKernel_success_empty(tcb_t *thread);
 
@@ -15,10 +15,19 @@
 exception_t decodeIRQControlInvocation(word_t invLabel, word_t length,
                                        cte_t *srcSlot, word_t *buffer);
 exception_t invokeIRQControl(irq_t irq, cte_t *handlerSlot, cte_t *controlSlot);
-exception_t decodeIRQHandlerInvocation(word_t invLabel, irq_t irq);
+exception_t decodeIRQHandlerInvocation(word_t invLabel, irq_t irq, word_t length, word_t *buffer);
 void invokeIRQHandler_AckIRQ(irq_t irq);
 void invokeIRQHandler_SetIRQHandler(irq_t irq, cap_t cap, cte_t *slot);
 void invokeIRQHandler_ClearIRQHandler(irq_t irq);
+#ifdef CONFIG_IRQ_RATE_LIMIT
+void invokeIRQHandler_SetRateLimit(irq_t irq, ticks_t interval);
+#endif
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+void invokeIRQHandler_SetDeferredDeactivate(irq_t irq, bool_t defer);
+/* Deactivate the IRQs signalling the given notification whose deactivation
+ * was deferred to user level. */
+void ackDeferredIRQs(notification_t *ntfnPtr);
+#endif
 void deletingIRQHandler(irq_t irq);
 void deletedIRQHandler(irq_t irq);
 void handleInterrupt(irq_t irq);
@@ -27,6 +27,21 @@ enum irq_state {
 };
 typedef word_t irq_state_t;
 
+#ifdef CONFIG_IRQ_RATE_LIMIT
+typedef struct irq_rate_limit {
+    /* minimum time between two deliveries, 0 if the IRQ is not rate limited */
+    ticks_t interval;
+    /* earliest time of the next delivery */
+    ticks_t next;
+    /* an interrupt arrived before 'next' and is delivered at 'next' */
+    bool_t deferred;
+#ifdef ENABLE_SMP_SUPPORT
+    /* core whose timer delivers the deferred interrupt */
+    word_t core;
+#endif
+} irq_rate_limit_t;
+#endif
+
 typedef struct dschedule {
     dom_t domain;
     word_t length;
@@ -293,6 +308,11 @@ struct tcb {
     word_t tcbAffinity;
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_FPU_EAGER_SWITCH
+    /* lazy FPU faults and eager FPU restores of this thread, 1 word */
+    word_t tcbFPUUsage;
+#endif
+
     /* Previous and next pointers for scheduler queues , 2 words */
     struct tcb *tcbSchedNext;
     struct tcb *tcbSchedPrev;
@@ -300,6 +320,19 @@ struct tcb {
     struct tcb *tcbEPNext;
     struct tcb *tcbEPPrev;
 
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+    /* Sender at which a preempted cancelBadgedSends of this thread resumes,
+     * and the badge being cancelled, 2 words */
+    struct tcb *tcbCancelCursor;
+    word_t tcbCancelBadge;
+    /* Thread whose tcbCancelCursor points at this sender, 1 word */
+    struct tcb *tcbCancelOwner;
+#ifdef CONFIG_KERNEL_MCS
+    /* Value of ksEPReorders when tcbCancelCursor was recorded, 1 word */
+    word_t tcbCancelReorders;
+#endif
+#endif
+
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
     /* 16 bytes (12 bytes aarch32) */
     benchmark_util_t benchmark;
@@ -410,6 +443,10 @@ compile_assert(notification_size_sane, sizeof(notification_t) == BIT(seL4_Notifi
 
 /* Check the IPC buffer is the right size */
 compile_assert(ipc_buf_size_sane, sizeof(seL4_IPCBuffer) == BIT(seL4_IPCBufferSizeBits))
+#ifdef CONFIG_BATCH_INVOCATION
+/* Batch records are passed to decodeInvocation in place of an IPC buffer */
+compile_assert(batch_record_msg_sane, OFFSETOF(seL4_BatchRecord, msg) == OFFSETOF(seL4_IPCBuffer, msg))
+#endif
 #ifdef CONFIG_KERNEL_MCS
 compile_assert(sc_core_size_sane, (sizeof(sched_context_t) + MIN_REFILLS *sizeof(refill_t) ==
                                    seL4_CoreSchedContextBytes))
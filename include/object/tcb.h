@@ -15,7 +15,7 @@
 
 #ifdef CONFIG_DEBUG_BUILD
 /* Maximum length of the tcb name, including null terminator */
-#define TCB_NAME_LENGTH (BIT(seL4_TCBBits-1) - (tcbCNodeEntries * sizeof(cte_t)) - sizeof(debug_tcb_t))
+#define TCB_NAME_LENGTH (BIT(seL4_TCBBits-1) - (tcbArchCNodeEntries * sizeof(cte_t)) - sizeof(debug_tcb_t))
 compile_assert(tcb_name_fits, TCB_NAME_LENGTH > 0)
 #endif
 
@@ -129,6 +129,11 @@ void remoteTCBStall(tcb_t *tcb);
 #define SCHED_APPEND_CURRENT_TCB    tcbSchedAppend(NODE_STATE(ksCurThread))
 
 #ifdef CONFIG_KERNEL_MCS
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+/* Declared here rather than in model/statedata.h, which includes this file */
+extern word_t ksEPReorders;
+#endif
+
 /* Add TCB into the priority ordered endpoint queue */
 static inline tcb_queue_t tcbEPAppend(tcb_t *tcb, tcb_queue_t queue)
 {
@@ -154,6 +159,10 @@ static inline tcb_queue_t tcbEPAppend(tcb_t *tcb, tcb_queue_t queue)
         queue.end = tcb;
     } else {
         after->tcbEPPrev = tcb;
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+        /* The tcb may now sit in front of a recorded cancellation cursor */
+        ksEPReorders++;
+#endif
     }
 
     tcb->tcbEPNext = after;
@@ -172,6 +181,34 @@ void setupCallerCap(tcb_t *sender, tcb_t *receiver, bool_t canGrant);
 void deleteCallerCap(tcb_t *receiver);
 #endif
 
+#ifdef CONFIG_IPC_BURST_COPY
+#define IPC_BURST_WORDS (L1_CACHE_LINE_SIZE / sizeof(word_t))
+
+/* Copy n words of an IPC buffer, a cache line at a time. Each burst is read
+ * into a local array before it is written, so the compiler can issue all loads
+ * of a burst back to back. Vector registers are not used, as the kernel does
+ * not preserve user FPU state. */
+static inline void copyIPCBufferWords(word_t *dest, const word_t *src, word_t n)
+{
+    word_t i, j;
+
+    for (i = 0; i + IPC_BURST_WORDS <= n; i += IPC_BURST_WORDS) {
+        word_t burst[IPC_BURST_WORDS];
+
+        for (j = 0; j < IPC_BURST_WORDS; j++) {
+            burst[j] = src[i + j];
+        }
+        for (j = 0; j < IPC_BURST_WORDS; j++) {
+            dest[i + j] = burst[j];
+        }
+    }
+
+    for (; i < n; i++) {
+        dest[i] = src[i];
+    }
+}
+#endif
+
 word_t copyMRs(tcb_t *sender, word_t *sendBuf, tcb_t *receiver,
                word_t *recvBuf, word_t n);
 exception_t decodeTCBInvocation(word_t invLabel, word_t length, cap_t cap,
@@ -34,3 +34,20 @@ exception_t invokeUntyped_Retype(cte_t *srcSlot, bool_t reset,
                                  void *retypeBase, object_t newType, word_t userSize,
                                  cte_t *destCNode, word_t destOffset, word_t destLength,
                                  bool_t deviceMemory);
+#ifdef CONFIG_UNTYPED_RESET
+exception_t invokeUntyped_Reset(cte_t *srcSlot);
+#endif
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+exception_t invokeUntyped_RetypeMap(cte_t *srcSlot, bool_t reset,
+                                    void *retypeBase, object_t newType, word_t userSize,
+                                    cte_t *destCNode, word_t destOffset, word_t destLength,
+                                    bool_t deviceMemory, cap_t vspaceCap, vptr_t vaddr,
+                                    word_t rightsMask, word_t attr);
+
+/* Implemented by the architecture: check that count frames of newType can be
+ * mapped into vspaceCap from vaddr on, and map the new frame caps in slots. */
+exception_t Arch_decodeUntypedRetypeMap(object_t newType, word_t count,
+                                        cap_t vspaceCap, vptr_t vaddr);
+void Arch_performUntypedRetypeMap(cte_t *slots, word_t count, cap_t vspaceCap,
+                                  vptr_t vaddr, word_t rightsMask, word_t attr);
+#endif
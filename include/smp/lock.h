@@ -135,31 +135,192 @@ static inline bool_t FORCE_INLINE clh_is_self_in_queue(void)
     return big_kernel_lock.node_owners[getCurrentCPUIndex()].node->value == CLHState_Pending;
 }
 
+#ifdef CONFIG_SMP_NODE_LOCKS
+
+/* Node locks allow the IPC fastpath to run concurrently on several cores.
+ *
+ * Each core has a lock protecting its node-local state (ready queues,
+ * current thread). A fastpath entry only takes its own node lock, and then
+ * an endpoint lock for the endpoint it operates on. Every other kernel
+ * entry takes the big kernel lock, whose holder sets 'exclusive' and waits
+ * for all node locks to be dropped, so it still has the whole kernel to
+ * itself. A fastpath that has to fall back to the slowpath drops its node
+ * lock and takes the big kernel lock instead.
+ *
+ * Taking a node lock only writes the core's own cache line and reads
+ * 'exclusive', which is shared read-only while no core holds the big
+ * kernel lock, so same-core IPC does not touch the CLH queue head. */
+
+#define NUM_EP_LOCKS 64
+
+typedef struct node_lock {
+    word_t held;
+    /* endpoint lock held by the fastpath on this node, if any */
+    word_t *ep_lock;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t) + sizeof(word_t *));
+} node_lock_t;
+
+typedef struct ep_lock {
+    word_t held;
+
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t));
+} ep_lock_t;
+
+typedef struct node_locks {
+    node_lock_t nodes[CONFIG_MAX_NUM_NODES];
+    ep_lock_t eps[NUM_EP_LOCKS];
+
+    word_t exclusive;
+    PAD_TO_NEXT_CACHE_LN(sizeof(word_t));
+} node_locks_t;
+
+extern node_locks_t node_locks;
+
+static inline bool_t FORCE_INLINE node_lock_is_held(word_t cpu)
+{
+    return node_locks.nodes[cpu].held;
+}
+
+static inline bool_t FORCE_INLINE node_lock_try_acquire(word_t cpu)
+{
+    __atomic_store_n(&node_locks.nodes[cpu].held, 1, __ATOMIC_RELAXED);
+
+    /* Order the store above against the load of 'exclusive' below. The big
+     * lock holder does the same in the opposite direction, so at least one
+     * of the two sees the other. */
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    if (likely(!__atomic_load_n(&node_locks.exclusive, __ATOMIC_RELAXED))) {
+        return true;
+    }
+
+    __atomic_store_n(&node_locks.nodes[cpu].held, 0, __ATOMIC_RELAXED);
+    return false;
+}
+
+static inline void FORCE_INLINE node_lock_release(word_t cpu)
+{
+    if (node_locks.nodes[cpu].ep_lock) {
+        __atomic_store_n(node_locks.nodes[cpu].ep_lock, 0, __ATOMIC_RELEASE);
+        node_locks.nodes[cpu].ep_lock = NULL;
+    }
+    __atomic_store_n(&node_locks.nodes[cpu].held, 0, __ATOMIC_RELEASE);
+}
+
+/* Returns false if the fastpath must leave the endpoint to the slowpath
+ * because a fastpath on another core is operating on it. */
+static inline bool_t FORCE_INLINE node_lock_try_acquire_ep(word_t cpu, void *ep)
+{
+    word_t *lock;
+
+    if (!node_lock_is_held(cpu)) {
+        /* running under the big kernel lock */
+        return true;
+    }
+
+    lock = &node_locks.eps[((word_t)ep >> seL4_EndpointBits) % NUM_EP_LOCKS].held;
+    if (__atomic_exchange_n(lock, 1, __ATOMIC_ACQUIRE)) {
+        return false;
+    }
+    node_locks.nodes[cpu].ep_lock = lock;
+    return true;
+}
+
+/* Called with the big kernel lock held to wait for the fastpaths on all
+ * other cores to finish and keep new ones out. */
+static inline void FORCE_INLINE node_lock_exclude_all(word_t cpu)
+{
+    __atomic_store_n(&node_locks.exclusive, 1, __ATOMIC_RELAXED);
+    __atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+    for (word_t i = 0; i < CONFIG_MAX_NUM_NODES; i++) {
+        if (i != cpu) {
+            while (__atomic_load_n(&node_locks.nodes[i].held, __ATOMIC_RELAXED)) {
+                arch_pause();
+            }
+        }
+    }
+
+    __atomic_thread_fence(__ATOMIC_ACQUIRE);
+}
+
+static inline void FORCE_INLINE node_lock_admit_all(void)
+{
+    __atomic_store_n(&node_locks.exclusive, 0, __ATOMIC_RELEASE);
+}
+
 #define NODE_LOCK(_irqPath) do {                         \
     clh_lock_acquire(getCurrentCPUIndex(), _irqPath);    \
+    node_lock_exclude_all(getCurrentCPUIndex());         \
 } while(0)
 
 #define NODE_UNLOCK do {                                 \
-    clh_lock_release(getCurrentCPUIndex());              \
+    if (node_lock_is_held(getCurrentCPUIndex())) {       \
+        node_lock_release(getCurrentCPUIndex());         \
+    } else {                                             \
+        node_lock_admit_all();                           \
+        clh_lock_release(getCurrentCPUIndex());          \
+    }                                                    \
 } while(0)
 
-#define NODE_LOCK_IF(_cond, _irqPath) do {               \
-    if((_cond)) {                                        \
-        NODE_LOCK(_irqPath);                             \
+#define NODE_UNLOCK_IF_HELD do {                         \
+    if (node_lock_is_held(getCurrentCPUIndex()) ||       \
+        clh_is_self_in_queue()) {                        \
+        NODE_UNLOCK;                                     \
+    }                                                    \
+} while(0)
+
+/* Used on entry to the IPC fastpath */
+#define NODE_LOCK_FASTPATH do {                          \
+    if (!node_lock_try_acquire(getCurrentCPUIndex())) {  \
+        NODE_LOCK(false);                                \
+    }                                                    \
+} while(0)
+
+/* Used on entry to the slowpath, which may be reached from a fastpath
+ * running under its node lock */
+#define NODE_LOCK_SLOWPATH do {                          \
+    if (node_lock_is_held(getCurrentCPUIndex())) {       \
+        node_lock_release(getCurrentCPUIndex());         \
+        NODE_LOCK(false);                                \
     }                                                    \
 } while(0)
 
+#else
+
+#define NODE_LOCK(_irqPath) do {                         \
+    clh_lock_acquire(getCurrentCPUIndex(), _irqPath);    \
+} while(0)
+
+#define NODE_UNLOCK do {                                 \
+    clh_lock_release(getCurrentCPUIndex());              \
+} while(0)
+
 #define NODE_UNLOCK_IF_HELD do {                         \
     if(clh_is_self_in_queue()) {                         \
         NODE_UNLOCK;                                     \
     }                                                    \
 } while(0)
 
+#define NODE_LOCK_FASTPATH NODE_LOCK(false)
+#define NODE_LOCK_SLOWPATH do {} while (0)
+
+#endif /* CONFIG_SMP_NODE_LOCKS */
+
+#define NODE_LOCK_IF(_cond, _irqPath) do {               \
+    if((_cond)) {                                        \
+        NODE_LOCK(_irqPath);                             \
+    }                                                    \
+} while(0)
+
 #else
 #define NODE_LOCK(_irq) do {} while (0)
 #define NODE_UNLOCK do {} while (0)
 #define NODE_LOCK_IF(_cond, _irq) do {} while (0)
 #define NODE_UNLOCK_IF_HELD do {} while (0)
+#define NODE_LOCK_FASTPATH do {} while (0)
+#define NODE_LOCK_SLOWPATH do {} while (0)
 #endif /* ENABLE_SMP_SUPPORT */
 
 #define NODE_LOCK_SYS NODE_LOCK(false)
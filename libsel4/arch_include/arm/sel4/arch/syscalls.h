@@ -722,6 +722,23 @@ LIBSEL4_INLINE_FUNC void seL4_BenchmarkFlushL1Caches(seL4_Word cache_type)
     asm volatile("" ::: "memory");
 }
 
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+LIBSEL4_INLINE_FUNC seL4_Error seL4_BenchmarkGetEntryHistogram(seL4_Word core, seL4_Word index)
+{
+    seL4_Word unused0 = 0;
+    seL4_Word unused1 = 0;
+    seL4_Word unused2 = 0;
+    seL4_Word unused3 = 0;
+    seL4_Word unused4 = 0;
+    seL4_Word ret;
+
+    arm_sys_send_recv(seL4_SysBenchmarkGetEntryHistogram, core, &ret, index, &unused0, &unused1, &unused2, &unused3, &unused4,
+                      0);
+
+    return (seL4_Error)ret;
+}
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
+
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 LIBSEL4_INLINE_FUNC void seL4_BenchmarkGetThreadUtilisation(seL4_Word tcb_cptr)
 {
@@ -787,6 +804,26 @@ LIBSEL4_INLINE_FUNC void seL4_SetTLSBase(seL4_Word tls_base)
 }
 #endif /* CONFIG_SET_TLS_BASE_SELF */
 
+#ifdef CONFIG_BATCH_INVOCATION
+LIBSEL4_INLINE_FUNC seL4_Error seL4_Batch(seL4_CPtr batch_frame)
+{
+    seL4_MessageInfo_t info;
+    seL4_Word mr0 = 0;
+    seL4_Word mr1 = 0;
+    seL4_Word mr2 = 0;
+    seL4_Word mr3 = 0;
+
+    arm_sys_send_recv(seL4_SysBatch, batch_frame, &batch_frame, 0, &info.words[0], &mr0, &mr1, &mr2, &mr3, 0);
+
+    seL4_SetMR(0, mr0);
+    seL4_SetMR(1, mr1);
+    seL4_SetMR(2, mr2);
+    seL4_SetMR(3, mr3);
+
+    return (seL4_Error) seL4_MessageInfo_get_label(info);
+}
+#endif /* CONFIG_BATCH_INVOCATION */
+
 #ifndef CONFIG_KERNEL_MCS
 LIBSEL4_INLINE_FUNC void seL4_Wait(seL4_CPtr src, seL4_Word *sender)
 {
@@ -29,6 +29,8 @@ typedef enum {
     seL4_ARM_ParityEnabled = 0x02,
     seL4_ARM_Default_VMAttributes = 0x03,
     seL4_ARM_ExecuteNever  = 0x04,
+    /* only honoured by AArch64 kernels built with KernelArmContiguousHint */
+    seL4_ARM_ContiguousHint = 0x08,
     /* seL4_ARM_PageCacheable | seL4_ARM_ParityEnabled */
     SEL4_FORCE_LONG_ENUM(seL4_ARM_VMAttributes),
 } seL4_ARM_VMAttributes;
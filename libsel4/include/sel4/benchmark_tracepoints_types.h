@@ -13,4 +13,31 @@ typedef struct benchmark_tracepoint_log_entry {
     seL4_Word  id;
     seL4_Word  duration;
 } benchmark_tracepoint_log_entry_t;
+
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+/* The log buffer is split into one ring per core. The ring of core c starts
+ * seL4_TracepointRingBytes * c bytes into the log buffer. */
+#define seL4_TracepointRingBytes (seL4_LogBufferSize / CONFIG_MAX_NUM_NODES)
+#define seL4_TracepointRingEntries ((seL4_TracepointRingBytes - 2 * sizeof(seL4_Word)) / \
+                                    sizeof(benchmark_tracepoint_log_entry_t))
+
+/**
+ * @brief Tracepoint ring of a core
+ *
+ * head is the number of entries the kernel has written to the ring since the
+ * log was reset, and entry n is stored in entries[n % seL4_TracepointRingEntries].
+ * The kernel writes an entry before it publishes the incremented head, so a
+ * reader that loads head with acquire ordering can read the entries before it.
+ * An entry that was read may have been overwritten by the time the reader is
+ * done; reading head again and discarding every entry idx at least
+ * seL4_TracepointRingEntries behind it (head - idx >= seL4_TracepointRingEntries)
+ * detects this. finalized is the value head had at the last
+ * seL4_BenchmarkFinalizeLog call.
+ */
+typedef struct benchmark_tracepoint_ring {
+    seL4_Word head;
+    seL4_Word finalized;
+    benchmark_tracepoint_log_entry_t entries[];
+} benchmark_tracepoint_ring_t;
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
 #endif /* CONFIG_BENCHMARK_TRACEPOINTS */
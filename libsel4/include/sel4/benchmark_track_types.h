@@ -7,6 +7,7 @@
 #pragma once
 
 #include <sel4/config.h>
+#include <sel4/macros.h>
 #include <stdint.h>
 
 #if (defined CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || defined CONFIG_DEBUG_BUILD)
@@ -62,3 +63,27 @@ typedef struct benchmark_syscall_log_entry {
 } benchmark_track_kernel_entry_t;
 
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES || CONFIG_DEBUG_BUILD */
+
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+
+/* Number of keyed histograms per core. The histogram after the last one counts
+ * the entries for which no keyed histogram was free. */
+#define seL4_BenchmarkEntryHistograms LIBSEL4_BIT(CONFIG_BENCHMARK_ENTRY_HISTOGRAM_BITS)
+
+/* Number of log2 duration buckets in a histogram */
+#define seL4_BenchmarkEntryHistogramBuckets 32
+
+/**
+ * @brief Kernel entry duration histogram
+ *
+ * count[i] is the number of kernel entries with the key `entry` that took between
+ * 2^i and 2^(i+1) - 1 timestamp ticks. count[0] also includes entries of zero ticks
+ * and the last bucket has no upper bound.
+ */
+typedef struct benchmark_entry_histogram {
+    kernel_entry_t entry;
+    uint32_t in_use;
+    uint64_t count[seL4_BenchmarkEntryHistogramBuckets];
+} benchmark_entry_histogram_t;
+
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
@@ -40,6 +40,16 @@ enum benchmark_track_util_ipc_index {
     BENCHMARK_TOTAL_KERNEL_UTILISATION,
     /* Total number of times the kernel is entered on the current core */
     BENCHMARK_TOTAL_NUMBER_KERNEL_ENTRIES,
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    /* Total number of TLB shootdown IPIs sent by the current core */
+    BENCHMARK_TOTAL_SHOOTDOWN_IPIS_SENT,
+    /* Total number of TLB shootdown IPIs the current core merged into another one */
+    BENCHMARK_TOTAL_SHOOTDOWN_IPIS_AVOIDED,
+#endif
+#ifdef CONFIG_IRQ_RATE_LIMIT
+    /* Total number of interrupts the current core folded into a later delivery */
+    BENCHMARK_TOTAL_SUPPRESSED_IRQS,
+#endif
 };
 
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
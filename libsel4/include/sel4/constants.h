@@ -57,6 +57,12 @@ enum seL4_MsgLimits {
 
 #define seL4_MsgMaxExtraCaps (LIBSEL4_BIT(seL4_MsgExtraCapBits)-1)
 
+/* Message length limit for a single seL4_Batch record, chosen to make a record
+ * 16 words long */
+enum seL4_BatchLimits {
+    seL4_BatchMsgMaxLength = 11
+};
+
 /* seL4_CapRights_t defined in shared_types_*.bf */
 #define seL4_CapRightsBits 4
 
@@ -18,6 +18,23 @@ typedef struct seL4_IPCBuffer_ {
     seL4_Word receiveDepth;
 } seL4_IPCBuffer __attribute__((__aligned__(sizeof(struct seL4_IPCBuffer_))));
 
+/* A single invocation performed by seL4_Batch. tag and msg are laid out as in
+ * seL4_IPCBuffer, dest is the invoked capability and caps the extra caps. */
+typedef struct seL4_BatchRecord_ {
+    seL4_MessageInfo_t tag;
+    seL4_Word msg[seL4_BatchMsgMaxLength];
+    seL4_CPtr dest;
+    seL4_CPtr caps[seL4_MsgMaxExtraCaps];
+} seL4_BatchRecord;
+
+/* Layout of the frame passed to seL4_Batch. The kernel performs records
+ * [completed, count) and advances completed after each one. */
+typedef struct seL4_BatchBuffer_ {
+    seL4_Word count;
+    seL4_Word completed;
+    seL4_BatchRecord records[];
+} seL4_BatchBuffer;
+
 typedef enum {
     seL4_CapFault_IP,
     seL4_CapFault_Addr,
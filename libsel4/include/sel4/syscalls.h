@@ -188,6 +188,8 @@ seL4_DebugRun(void (* userfn)(void *), void *userarg);
  *    3. `BENCHMARK_TRACK_UTILISATION`: resets benchmark and current thread
  *        start time (to the time of invoking this syscall), resets idle
  *        thread utilisation to 0, and starts tracking utilisation.
+ *    4. `BENCHMARK_ENTRY_HISTOGRAMS`: clears the kernel entry histograms of all cores,
+ *    5. `BENCHMARK_TRACEPOINTS_RING`: empties the tracepoint rings of all cores.
  *
  * @return A `seL4_Error` error if the user-level log buffer has not been set by the user
  *                         (`BENCHMARK_TRACEPOINTS`/`BENCHMARK_TRACK_KERNEL_ENTRIES`).
@@ -202,9 +204,11 @@ seL4_BenchmarkResetLog(void);
  * The behaviour of this system call depends on benchmarking mode in action while invoking this system call:
  *    1. `BENCHMARK_TRACEPOINTS`: Sets the final log buffer index to the current index,
  *    2. `BENCHMARK_TRACK_KERNEL_ENTRIES`:  as above,
- *    3. `BENCHMARK_TRACK_UTILISATION`: sets benchmark end time to current time, stops tracking utilisation.
+ *    3. `BENCHMARK_TRACK_UTILISATION`: sets benchmark end time to current time, stops tracking utilisation,
+ *    4. `BENCHMARK_TRACEPOINTS_RING`: copies the head of every core's tracepoint ring to its `finalized` field; logging continues.
  *
- * @return The index of the final entry in the log buffer (if `BENCHMARK_TRACEPOINTS`/`BENCHMARK_TRACK_KERNEL_ENTRIES` are enabled).
+ * @return The index of the final entry in the log buffer (if `BENCHMARK_TRACEPOINTS`/`BENCHMARK_TRACK_KERNEL_ENTRIES` are enabled),
+ *         or the total number of entries written to all rings (if `BENCHMARK_TRACEPOINTS_RING` is enabled).
  *
  */
 LIBSEL4_INLINE_FUNC seL4_Word
@@ -257,6 +261,26 @@ LIBSEL4_INLINE_FUNC void
 seL4_BenchmarkFlushL1Caches(seL4_Word cache_type);
 #endif
 
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+/**
+ * @xmlonly <manual name="Get Entry Histogram" label="sel4_benchmarkgetentryhistogram"/> @endxmlonly
+ * @brief Read a kernel entry duration histogram.
+ *
+ * Copy one of the kernel entry histograms kept for a core into the caller's IPC buffer, starting at the
+ * first message register, as a `benchmark_entry_histogram_t`. Each core has `seL4_BenchmarkEntryHistograms`
+ * histograms, each counting the entries with one (path, syscall, cap type, invocation label, fastpath) key,
+ * and an overflow histogram at index `seL4_BenchmarkEntryHistograms` that counts the entries for which no
+ * histogram was free. Histograms without a key have `in_use` cleared.
+ *
+ * @param[in] core  The core whose histogram to read.
+ * @param[in] index The index of the histogram, up to and including `seL4_BenchmarkEntryHistograms`.
+ * @return A `seL4_InvalidArgument` error if `core` or `index` is out of range, or
+ *         `seL4_IllegalOperation` if the caller has no IPC buffer.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_BenchmarkGetEntryHistogram(seL4_Word core, seL4_Word index);
+#endif
+
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 /**
  * @xmlonly <manual name="Get Thread Utilisation" label="sel4_benchmarkgetthreadutilisation"/> @endxmlonly
@@ -390,3 +414,33 @@ LIBSEL4_INLINE_FUNC void
 seL4_SetTLSBase(seL4_Word tls_base);
 #endif
 
+#ifdef CONFIG_BATCH_INVOCATION
+/**
+ * @xmlonly <manual name="Batch" label="sel4_batch"/> @endxmlonly
+ * @brief Perform a list of invocations in a single kernel entry.
+ *
+ * The frame holds an seL4_BatchBuffer. The kernel performs the records from
+ * `completed` up to `count` in order, as if each had been sent with seL4_Send,
+ * and increments `completed` after each record. It stops at the first record
+ * that fails, leaving `completed` at the index of that record. Replies of
+ * individual invocations are discarded.
+ *
+ * Records may not invoke endpoint, notification or reply capabilities. A record
+ * message may be at most seL4_BatchMsgMaxLength words long; message words
+ * beyond the message registers are read from the record, not the IPC buffer.
+ *
+ * The batch may be preempted between or during records, in which case it is
+ * restarted transparently from `completed`. A record that is preempted part way
+ * may have its `dest` and message words rewritten to describe the work that
+ * remains, as the arguments of a range invocation are advanced past the frames
+ * that are done.
+ *
+ * @param batch_frame A capability to a writable, non-device frame holding the batch.
+ * @return `seL4_NoError` if all records completed, otherwise the error of the failing
+ *         record or of the batch itself, with details in the message registers as for
+ *         any other invocation.
+ */
+LIBSEL4_INLINE_FUNC seL4_Error
+seL4_Batch(seL4_CPtr batch_frame);
+#endif
+
@@ -12,6 +12,7 @@
 #include <benchmark/benchmark_utilisation.h>
 #include <api/syscall.h>
 #include <api/failures.h>
+#include <api/invocation.h>
 #include <api/faults.h>
 #include <kernel/cspace.h>
 #include <kernel/faulthandler.h>
@@ -21,6 +22,7 @@
 #include <plat/machine/hardware.h>
 #include <object/interrupt.h>
 #include <model/statedata.h>
+#include <model/preemption.h>
 #include <string.h>
 #include <kernel/traps.h>
 #include <arch/machine.h>
@@ -197,6 +199,10 @@ exception_t handleUnknownSyscall(word_t w)
         return handle_SysBenchmarkResetAllThreadsUtilisation();
 #endif /* CONFIG_DEBUG_BUILD */
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+    case SysBenchmarkGetEntryHistogram:
+        return handle_SysBenchmarkGetEntryHistogram();
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
     case SysBenchmarkNullSyscall:
         return EXCEPTION_NONE;
     default:
@@ -256,6 +262,17 @@ exception_t handleVMFaultEvent(vm_fault_type_t vm_faultType)
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+/* A cancelBadgedSends cursor is only kept for the restart of the invocation
+ * that recorded it */
+static inline void clearStaleCancelCursor(tcb_t *thread, seL4_MessageInfo_t info)
+{
+    if (seL4_MessageInfo_get_label(info) != CNodeCancelBadgedSends) {
+        clearCancelCursor(thread);
+    }
+}
+#endif
+
 #ifdef CONFIG_KERNEL_MCS
 static exception_t handleInvocation(bool_t isCall, bool_t isBlocking, bool_t canDonate, bool_t firstPhase, cptr_t cptr)
 #else
@@ -275,6 +292,9 @@ static exception_t handleInvocation(bool_t isCall, bool_t isBlocking)
 #ifndef CONFIG_KERNEL_MCS
     cptr_t cptr = getRegister(thread, capRegister);
 #endif
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+    clearStaleCancelCursor(thread, info);
+#endif
 
     /* faulting section */
     lu_ret = lookupCapAndSlot(thread, cptr);
@@ -511,10 +531,242 @@ static void handleYield(void)
 #endif
 }
 
+#ifdef CONFIG_BATCH_INVOCATION
+/* Perform a single batch record as if the current thread had sent it with
+ * seL4_Send. Errors that would raise a fault on the normal invocation path are
+ * reported as syscall errors instead, as the batch stops at the first failing
+ * record. */
+static exception_t handleBatchRecord(tcb_t *thread, seL4_BatchRecord *record)
+{
+    seL4_MessageInfo_t info;
+    lookupCapAndSlot_ret_t lu_ret;
+    lookupSlot_raw_ret_t lu_extra;
+    word_t length, extraCaps, i;
+    cptr_t cptr;
+
+    info = messageInfoFromWord(record->tag.words[0]);
+    length = seL4_MessageInfo_get_length(info);
+    extraCaps = seL4_MessageInfo_get_extraCaps(info);
+    cptr = record->dest;
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+    clearStaleCancelCursor(thread, info);
+#endif
+
+    if (unlikely(length > seL4_BatchMsgMaxLength)) {
+        userError("Batch: record message too long.");
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = seL4_BatchMsgMaxLength;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    lu_ret = lookupCapAndSlot(thread, cptr);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+        userError("Batch: invocation of invalid cap #%lu.", cptr);
+        current_syscall_error.type = seL4_FailedLookup;
+        current_syscall_error.failedLookupWasSource = false;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* IPC would block the thread in the middle of the batch */
+    switch (cap_get_capType(lu_ret.cap)) {
+    case cap_endpoint_cap:
+    case cap_notification_cap:
+    case cap_reply_cap:
+        userError("Batch: cap #%lu is not a kernel object.", cptr);
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    default:
+        break;
+    }
+
+    for (i = 0; i < extraCaps; i++) {
+        lu_extra = lookupSlot(thread, record->caps[i]);
+        if (unlikely(lu_extra.status != EXCEPTION_NONE)) {
+            userError("Batch: lookup of extra cap #%lu failed.", (word_t)record->caps[i]);
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        current_extra_caps.excaprefs[i] = lu_extra.slot;
+    }
+    if (i < seL4_MsgMaxExtraCaps) {
+        current_extra_caps.excaprefs[i] = NULL;
+    }
+
+    /* Arguments beyond the message registers are read from the record itself,
+     * which has the same layout as the start of an IPC buffer. */
+    for (i = 0; i < length && i < n_msgRegisters; i++) {
+        setRegister(thread, msgRegisters[i], record->msg[i]);
+    }
+    setRegister(thread, capRegister, cptr);
+
+#ifdef CONFIG_KERNEL_MCS
+    return decodeInvocation(seL4_MessageInfo_get_label(info), length,
+                            cptr, lu_ret.slot, lu_ret.cap,
+                            false, false, false, false, (word_t *)record);
+#else
+    return decodeInvocation(seL4_MessageInfo_get_label(info), length,
+                            cptr, lu_ret.slot, lu_ret.cap,
+                            false, false, (word_t *)record);
+#endif
+}
+
+/* An invocation that is preempted part way, such as a frame range invocation,
+ * may rewrite its arguments and the invoked cptr to record its progress. Store
+ * them in the record, from which they are reloaded when the batch restarts. */
+static void saveBatchRecordArgs(tcb_t *thread, seL4_BatchRecord *record)
+{
+    word_t length, i;
+
+    length = seL4_MessageInfo_get_length(messageInfoFromWord(record->tag.words[0]));
+    for (i = 0; i < length && i < n_msgRegisters; i++) {
+        record->msg[i] = getRegister(thread, msgRegisters[i]);
+    }
+    record->dest = getRegister(thread, capRegister);
+}
+
+/* A record may delete the last cap to the batch frame, after which the memory
+ * can be retyped by a later record. Check that the frame cap still refers to
+ * the same frame before the kernel writes to it again. */
+static bool_t batchFrameUnchanged(tcb_t *thread, cptr_t frameCPtr, seL4_BatchBuffer *batch, word_t sizeBits)
+{
+    lookupCap_ret_t lu_ret;
+
+    lu_ret = lookupCap(thread, frameCPtr);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+        return false;
+    }
+
+    return (seL4_BatchBuffer *)lookupBatchBuffer(lu_ret.cap) == batch &&
+           cap_get_capSizeBits(lu_ret.cap) == sizeBits;
+}
+
+static exception_t handleBatch(void)
+{
+    tcb_t *thread;
+    cptr_t frameCPtr;
+    lookupCap_ret_t lu_ret;
+    seL4_BatchBuffer *batch;
+    word_t sizeBits, maxRecords, count, i, tsType;
+    exception_t status;
+
+    thread = NODE_STATE(ksCurThread);
+    frameCPtr = getRegister(thread, capRegister);
+
+    lu_ret = lookupCap(thread, frameCPtr);
+    if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+        userError("Batch: invalid frame cap #%lu.", frameCPtr);
+        current_syscall_error.type = seL4_FailedLookup;
+        current_syscall_error.failedLookupWasSource = false;
+        replyFromKernel_error(thread);
+        return EXCEPTION_NONE;
+    }
+
+    batch = (seL4_BatchBuffer *)lookupBatchBuffer(lu_ret.cap);
+    if (unlikely(batch == NULL)) {
+        userError("Batch: cap #%lu is not a writable memory frame.", frameCPtr);
+        current_syscall_error.type = seL4_IllegalOperation;
+        replyFromKernel_error(thread);
+        return EXCEPTION_NONE;
+    }
+
+    /* The frame is shared with user level, so read each control word once */
+    sizeBits = cap_get_capSizeBits(lu_ret.cap);
+    maxRecords = (BIT(sizeBits) - sizeof(seL4_BatchBuffer)) / sizeof(seL4_BatchRecord);
+    count = batch->count;
+    i = batch->completed;
+    if (unlikely(count > maxRecords)) {
+        userError("Batch: %lu records do not fit in the frame.", count);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = maxRecords;
+        replyFromKernel_error(thread);
+        return EXCEPTION_NONE;
+    }
+
+    /* Invocations that reply directly leave the thread running, so the state
+     * after a record only tells whether it blocked or stopped. The thread is
+     * set to restart again before each later record and preemption point. */
+    setThreadState(thread, ThreadState_Restart);
+    while (i < count) {
+        status = handleBatchRecord(thread, &batch->records[i]);
+
+        if (unlikely(status == EXCEPTION_PREEMPTED)) {
+            /* the record is restarted when the thread runs again */
+            if (likely(batchFrameUnchanged(thread, frameCPtr, batch, sizeBits))) {
+                saveBatchRecordArgs(thread, &batch->records[i]);
+            }
+            setRegister(thread, capRegister, frameCPtr);
+            return status;
+        }
+        setRegister(thread, capRegister, frameCPtr);
+
+        if (unlikely(status == EXCEPTION_SYSCALL_ERROR)) {
+            /* The thread was set to restart before the record */
+            setThreadState(thread, ThreadState_Running);
+            replyFromKernel_error(thread);
+            return EXCEPTION_NONE;
+        }
+
+        i++;
+        tsType = thread_state_get_tsType(thread->tcbState);
+        if (likely(batchFrameUnchanged(thread, frameCPtr, batch, sizeBits))) {
+            batch->completed = i;
+        } else if (tsType == ThreadState_Restart || tsType == ThreadState_Running) {
+            userError("Batch: frame cap #%lu was removed by record %lu.", frameCPtr, i - 1);
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            setThreadState(thread, ThreadState_Running);
+            replyFromKernel_error(thread);
+            return EXCEPTION_NONE;
+        }
+
+        /* The invocation may have suspended or deleted the current thread */
+        if (unlikely(tsType != ThreadState_Restart && tsType != ThreadState_Running)) {
+            return EXCEPTION_NONE;
+        }
+
+        if (i < count) {
+            setThreadState(thread, ThreadState_Restart);
+            status = preemptionPoint();
+            if (unlikely(status != EXCEPTION_NONE)) {
+                return status;
+            }
+        }
+    }
+
+    replyFromKernel_success_empty(thread);
+    setThreadState(thread, ThreadState_Running);
+
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_BATCH_INVOCATION */
+
 exception_t handleSyscall(syscall_t syscall)
 {
     exception_t ret;
     irq_t irq;
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+    /* Invocations keep the cursor only when restarting a cancellation */
+    switch (syscall) {
+    case SysSend:
+    case SysNBSend:
+    case SysCall:
+#ifdef CONFIG_KERNEL_MCS
+    case SysNBSendRecv:
+    case SysNBSendWait:
+#endif
+#ifdef CONFIG_BATCH_INVOCATION
+    /* each record checks the cursor itself */
+    case SysBatch:
+#endif
+        break;
+    default:
+        clearCancelCursor(NODE_STATE(ksCurThread));
+        break;
+    }
+#endif
     MCS_DO_IF_BUDGET({
         switch (syscall)
         {
@@ -618,6 +870,19 @@ exception_t handleSyscall(syscall_t syscall)
             handleYield();
             break;
 
+#ifdef CONFIG_BATCH_INVOCATION
+        case SysBatch:
+            ret = handleBatch();
+            if (unlikely(ret != EXCEPTION_NONE)) {
+                mcsPreemptionPoint();
+                irq = getActiveIRQ();
+                if (IRQT_TO_IRQ(irq) != IRQT_TO_IRQ(irqInvalid)) {
+                    handleInterrupt(irq);
+                }
+            }
+            break;
+#endif
+
         default:
             fail("Invalid syscall");
         }
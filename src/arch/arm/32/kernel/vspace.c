@@ -657,6 +657,24 @@ word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread)
     }
 }
 
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap)
+{
+    if (unlikely(cap_get_capType(cap) != cap_small_frame_cap &&
+                 cap_get_capType(cap) != cap_frame_cap)) {
+        return NULL;
+    }
+    if (unlikely(generic_frame_cap_get_capFIsDevice(cap))) {
+        return NULL;
+    }
+    if (unlikely(generic_frame_cap_get_capFVMRights(cap) != VMReadWrite)) {
+        return NULL;
+    }
+
+    return (word_t *)generic_frame_cap_get_capFBasePtr(cap);
+}
+#endif /* CONFIG_BATCH_INVOCATION */
+
 exception_t checkValidIPCBuffer(vptr_t vptr, cap_t cap)
 {
     if (unlikely(cap_get_capType(cap) != cap_small_frame_cap &&
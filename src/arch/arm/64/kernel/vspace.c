@@ -16,6 +16,7 @@
 #include <machine/io.h>
 #include <machine/debug.h>
 #include <model/statedata.h>
+#include <model/preemption.h>
 #include <object/cnode.h>
 #include <object/untyped.h>
 #include <arch/api/invocation.h>
@@ -192,7 +193,9 @@ BOOT_CODE void map_kernel_frame(paddr_t paddr, pptr_t vaddr, vm_rights_t vm_righ
         attr_index = DEVICE_nGnRnE;
         shareable = 0;
     }
-    armKSGlobalKernelPT[GET_KPT_INDEX(vaddr, KLVL_FRM_ARM_PT_LVL(3))] = pte_pte_4k_page_new(uxn, paddr,
+    armKSGlobalKernelPT[GET_KPT_INDEX(vaddr, KLVL_FRM_ARM_PT_LVL(3))] = pte_pte_4k_page_new(uxn,
+                                                                                            0, /* not contiguous */
+                                                                                            paddr,
                                                                                             0, /* global */
                                                                                             1, /* access flag */
                                                                                             shareable,
@@ -241,6 +244,7 @@ BOOT_CODE void map_kernel_window(void)
 #else
                                                                                                                         1, // UXN
 #endif
+                                                                                                                        0,                        /* not contiguous */
                                                                                                                         paddr,
                                                                                                                         0,                        /* global */
                                                                                                                         1,                        /* access flag */
@@ -296,6 +300,7 @@ static BOOT_CODE void map_it_frame_cap(cap_t vspace_cap, cap_t frame_cap, bool_t
     pt = paddr_to_pptr(pte_pte_table_ptr_get_pt_base_address(pd));
     *(pt + GET_UPT_INDEX(vptr, ULVL_FRM_ARM_PT_LVL(3))) = pte_pte_4k_page_new(
                                                               !executable,                    /* unprivileged execute never */
+                                                              0,                              /* not contiguous */
                                                               pptr_to_paddr(pptr),            /* page_base_address    */
 #ifdef CONFIG_ARM_HYPERVISOR_SUPPORT
                                                               0,
@@ -601,6 +606,23 @@ word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread)
     }
 }
 
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap)
+{
+    if (unlikely(cap_get_capType(cap) != cap_frame_cap)) {
+        return NULL;
+    }
+    if (unlikely(cap_frame_cap_get_capFIsDevice(cap))) {
+        return NULL;
+    }
+    if (unlikely(cap_frame_cap_get_capFVMRights(cap) != VMReadWrite)) {
+        return NULL;
+    }
+
+    return (word_t *)cap_frame_cap_get_capFBasePtr(cap);
+}
+#endif /* CONFIG_BATCH_INVOCATION */
+
 exception_t checkValidIPCBuffer(vptr_t vptr, cap_t cap)
 {
     if (cap_get_capType(cap) != cap_frame_cap) {
@@ -669,10 +691,10 @@ static pte_t makeUserPagePTE(paddr_t paddr, vm_rights_t vm_rights, vm_attributes
     word_t shareable = cacheable ? SMP_TERNARY(SMP_SHARE, 0) : 0;
 
     if (page_size == ARMSmallPage) {
-        return pte_pte_4k_page_new(nonexecutable, paddr, nG, 1 /* access flag */,
+        return pte_pte_4k_page_new(nonexecutable, 0 /* not contiguous */, paddr, nG, 1 /* access flag */,
                                    shareable, APFromVMRights(vm_rights), attridx);
     } else {
-        return pte_pte_page_new(nonexecutable, paddr, nG, 1 /* access flag */,
+        return pte_pte_page_new(nonexecutable, 0 /* not contiguous */, paddr, nG, 1 /* access flag */,
                                 shareable, APFromVMRights(vm_rights), attridx);
     }
 }
@@ -969,6 +991,84 @@ static inline void invalidateTLBByASIDVA(asid_t asid, vptr_t vaddr)
 }
 
 
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+/* A contiguous group is a naturally aligned run of BIT(PTE_CONTIGUOUS_BITS)
+ * page entries of one table. Once every entry maps the matching part of a
+ * physically contiguous region of the same alignment with identical
+ * attributes, the contiguous bit is set on all of them and the group may be
+ * cached as a single TLB entry. Any entry of the group that is changed
+ * afterwards first dissolves the group. */
+static inline pte_t *contiguousGroupBase(pte_t *ptSlot)
+{
+    return (pte_t *)ROUND_DOWN((word_t)ptSlot, PTE_CONTIGUOUS_BITS + PTE_SIZE_BITS);
+}
+
+static inline bool_t isContiguousGroupEnd(pte_t *ptSlot)
+{
+    return contiguousGroupBase(ptSlot + 1) == ptSlot + 1;
+}
+
+/* The contiguous bit may only change with break-before-make: all entries of
+ * the group are invalidated and their translations removed from the TLB
+ * before the new entries are written. No other core can observe the window,
+ * as the hint is only supported on uniprocessor kernels. */
+static void rewriteContiguousGroup(pte_t *group, asid_t asid, bool_t contiguous)
+{
+    pte_t entries[BIT(PTE_CONTIGUOUS_BITS)];
+    word_t i;
+
+    for (i = 0; i < BIT(PTE_CONTIGUOUS_BITS); i++) {
+        entries[i] = pte_set_contiguous(group[i], contiguous);
+        group[i] = pte_pte_invalid_new();
+    }
+    cleanCacheRange_PoU((vptr_t)group, (vptr_t)(group + BIT(PTE_CONTIGUOUS_BITS)) - 1,
+                        pptr_to_paddr(group));
+    assert(asid < BIT(16));
+    invalidateTLBByASID(asid);
+
+    for (i = 0; i < BIT(PTE_CONTIGUOUS_BITS); i++) {
+        group[i] = entries[i];
+    }
+    cleanCacheRange_PoU((vptr_t)group, (vptr_t)(group + BIT(PTE_CONTIGUOUS_BITS)) - 1,
+                        pptr_to_paddr(group));
+}
+
+static void breakContiguousGroup(pte_t *ptSlot, asid_t asid)
+{
+    if (unlikely(pte_get_contiguous(*ptSlot))) {
+        rewriteContiguousGroup(contiguousGroupBase(ptSlot), asid, false);
+    }
+}
+
+static void formContiguousGroup(pte_t *ptSlot, vm_page_size_t frameSize, asid_t asid)
+{
+    pte_t *group = contiguousGroupBase(ptSlot);
+    word_t frameBits = pageBitsForSize(frameSize);
+    paddr_t base;
+    word_t i;
+
+    if (!pte_is_page_type(group[0]) || pte_get_contiguous(group[0])) {
+        return;
+    }
+
+    base = pte_get_page_base_address(group[0]);
+    if (!IS_ALIGNED(base, frameBits + PTE_CONTIGUOUS_BITS)) {
+        return;
+    }
+
+    for (i = 1; i < BIT(PTE_CONTIGUOUS_BITS); i++) {
+        if (!pte_is_page_type(group[i]) ||
+            pte_get_page_base_address(group[i]) != base + (i << frameBits) ||
+            ((group[i].words[0] ^ group[0].words[0]) & ~PTE_PAGE_BASE_ADDRESS_MASK) != 0) {
+            return;
+        }
+    }
+
+    rewriteContiguousGroup(group, asid, true);
+}
+#endif /* CONFIG_ARM_CONTIGUOUS_HINT */
+
+
 void unmapPageTable(asid_t asid, vptr_t vptr, pte_t *target_pt)
 {
     findVSpaceForASID_ret_t find_ret = findVSpaceForASID(asid);
@@ -999,7 +1099,10 @@ void unmapPageTable(asid_t asid, vptr_t vptr, pte_t *target_pt)
     invalidateTLBByASID(asid);
 }
 
-void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
+/* Remove the mapping of pptr at vptr without cleaning the entry to the PoU or
+ * invalidating its translation. Returns the cleared entry, or NULL if there was
+ * no such mapping. */
+static pte_t *unmapPageEntry(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
 {
     findVSpaceForASID_ret_t find_ret;
     lookupPTSlot_ret_t  lu_ret;
@@ -1007,30 +1110,42 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
 
     find_ret = findVSpaceForASID(asid);
     if (find_ret.status != EXCEPTION_NONE) {
-        return;
+        return NULL;
     }
 
     lu_ret = lookupPTSlot(find_ret.vspace_root, vptr);
     if (unlikely(lu_ret.ptBitsLeft != pageBitsForSize(page_size))) {
         /* Do nothing if the wrong size object was returned */
-        return;
+        return NULL;
     }
 
     pte = *(lu_ret.ptSlot);
     if (!pte_is_page_type(pte)) {
         /* Do nothing if no page is present */
-        return;
+        return NULL;
     }
 
     if (pte_get_page_base_address(pte) != pptr_to_paddr((void *)pptr)) {
         /* Do nothing if the mapped page is not the same physical frame */
-        return;
+        return NULL;
     }
 
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+    breakContiguousGroup(lu_ret.ptSlot, asid);
+#endif
     *(lu_ret.ptSlot) = pte_pte_invalid_new();
-    cleanByVA_PoU((vptr_t)lu_ret.ptSlot, pptr_to_paddr(lu_ret.ptSlot));
-    assert(asid < BIT(16));
-    invalidateTLBByASIDVA(asid, vptr);
+    return lu_ret.ptSlot;
+}
+
+void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, pptr_t pptr)
+{
+    pte_t *ptSlot = unmapPageEntry(page_size, asid, vptr, pptr);
+
+    if (ptSlot != NULL) {
+        cleanByVA_PoU((vptr_t)ptSlot, pptr_to_paddr(ptSlot));
+        assert(asid < BIT(16));
+        invalidateTLBByASIDVA(asid, vptr);
+    }
 }
 
 void deleteASID(asid_t asid, vspace_root_t *vspace)
@@ -1165,6 +1280,9 @@ static exception_t performPageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlo
 {
     bool_t tlbflush_required = pte_ptr_get_valid(ptSlot);
 
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+    breakContiguousGroup(ptSlot, asid);
+#endif
     ctSlot->cap = cap;
     *ptSlot = pte;
 
@@ -1177,6 +1295,17 @@ static exception_t performPageInvocationMap(asid_t asid, cap_t cap, cte_t *ctSlo
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+static exception_t performPageInvocationMapContiguous(asid_t asid, cap_t cap, cte_t *ctSlot,
+                                                      pte_t pte, pte_t *ptSlot)
+{
+    exception_t status = performPageInvocationMap(asid, cap, ctSlot, pte, ptSlot);
+
+    formContiguousGroup(ptSlot, cap_frame_cap_get_capFSize(cap), asid);
+    return status;
+}
+#endif
+
 static exception_t performPageInvocationUnmap(cap_t cap, cte_t *ctSlot)
 {
     if (cap_frame_cap_get_capFMappedASID(cap) != 0) {
@@ -1459,6 +1588,420 @@ static inline bool_t CONST checkVPAlignment(vm_page_size_t sz, word_t w)
     return (w & MASK(pageBitsForSize(sz))) == 0;
 }
 
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+static inline void cleanPTERange(pte_t *start, pte_t *end)
+{
+    if (start != NULL) {
+        cleanCacheRange_PoU((vptr_t)start, (vptr_t)end - 1, pptr_to_paddr(start));
+    }
+}
+
+/* Rewrite the arguments of a preempted range invocation to describe the frames
+ * from done onwards, so that the restarted invocation continues with them. */
+static void advanceFrameRangeArgs(bool_t isMap, cptr_t cptr, vptr_t vaddr, word_t count,
+                                  word_t done, vm_page_size_t frameSize, word_t *buffer)
+{
+    tcb_t *thread = NODE_STATE(ksCurThread);
+
+    setRegister(thread, capRegister, cptr + done);
+    if (isMap) {
+        setMR(thread, buffer, 0, vaddr + (done << pageBitsForSize(frameSize)));
+        setMR(thread, buffer, 3, count - done);
+    } else {
+        setMR(thread, buffer, 0, count - done);
+    }
+}
+
+/* Invalidate the translations of count frames that a range invocation unmapped
+ * from asid, the last one at vaddr. */
+static void invalidateUnmappedFrames(asid_t asid, word_t count, vptr_t vaddr)
+{
+    if (count == 0) {
+        return;
+    }
+
+    assert(asid < BIT(16));
+    if (count == 1) {
+        invalidateTLBByASIDVA(asid, vaddr);
+    } else {
+        invalidateTLBByASID(asid);
+    }
+}
+
+/* Map or unmap the frames at count consecutive cptrs starting at cptr. Frames
+ * are decoded and performed one at a time, so an error leaves the frames before
+ * the failing one mapped or unmapped. Every frame, including one that is already
+ * in the requested state, counts towards preemption, and a preempted invocation
+ * is restarted with its arguments advanced past the completed frames. The cache
+ * maintenance of adjacent PTEs is merged. Overwritten entries of a map cost one
+ * TLB invalidation for the ASID, as do the entries that an unmap clears in each
+ * ASID. */
+static exception_t decodeARMFrameRangeInvocation(word_t invLabel, word_t length, cptr_t cptr,
+                                                 cte_t *cte, cap_t cap, word_t *buffer)
+{
+    vptr_t vaddr = 0;
+    word_t count, i;
+    word_t rightsMask = 0;
+    vm_attributes_t attributes = vmAttributesFromWord(0);
+    vm_page_size_t frameSize;
+    vspace_root_t *vspaceRoot = NULL;
+    asid_t asid = asidInvalid;
+    bool_t isMap = invLabel == ARMPageMapRange;
+    bool_t tlbflush_required = false;
+    pte_t *runStart = NULL, *runEnd = NULL;
+    asid_t unmapASID = asidInvalid;
+    word_t unmapped = 0;
+    vptr_t unmappedVaddr = 0;
+    exception_t status = EXCEPTION_NONE;
+
+    frameSize = cap_frame_cap_get_capFSize(cap);
+
+    if (isMap) {
+        cap_t vspaceRootCap;
+        findVSpaceForASID_ret_t find_ret;
+
+        if (unlikely(length < 4 || current_extra_caps.excaprefs[0] == NULL)) {
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        vaddr = getSyscallArg(0, buffer);
+        rightsMask = getSyscallArg(1, buffer);
+        attributes = vmAttributesFromWord(getSyscallArg(2, buffer));
+        count = getSyscallArg(3, buffer);
+        vspaceRootCap = current_extra_caps.excaprefs[0]->cap;
+
+        if (unlikely(!isValidNativeRoot(vspaceRootCap))) {
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 1;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        vspaceRoot = VSPACE_PTR(cap_vspace_cap_get_capVSBasePtr(vspaceRootCap));
+        asid = cap_vspace_cap_get_capVSMappedASID(vspaceRootCap);
+
+        find_ret = findVSpaceForASID(asid);
+        if (unlikely(find_ret.status != EXCEPTION_NONE)) {
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (unlikely(find_ret.vspace_root != vspaceRoot)) {
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 1;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (unlikely(!checkVPAlignment(frameSize, vaddr))) {
+            current_syscall_error.type = seL4_AlignmentError;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        /* written to avoid overflow in vaddr + count * frame size */
+        if (unlikely(vaddr > USER_TOP ||
+                     count > ((USER_TOP - vaddr + 1) >> pageBitsForSize(frameSize)))) {
+            userError("ARMPageMapRange: Mapping address too high.");
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 0;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    } else {
+        if (unlikely(length < 1)) {
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        count = getSyscallArg(0, buffer);
+    }
+
+    if (unlikely(count == 0)) {
+        userError("ARMPageRange: Empty range.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = isMap ? 3 : 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    for (i = 0; i < count; i++) {
+        cap_t frameCap = cap;
+        cte_t *frameSlot = cte;
+
+        if (i > 0) {
+            lookupCapAndSlot_ret_t lu_ret = lookupCapAndSlot(NODE_STATE(ksCurThread), cptr + i);
+            if (unlikely(lu_ret.status != EXCEPTION_NONE)) {
+                userError("ARMPageRange: Invalid cap #%lu.", cptr + i);
+                current_syscall_error.type = seL4_FailedLookup;
+                current_syscall_error.failedLookupWasSource = true;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+            frameCap = lu_ret.cap;
+            frameSlot = lu_ret.slot;
+
+            if (unlikely(cap_get_capType(frameCap) != cap_frame_cap ||
+                         cap_frame_cap_get_capFSize(frameCap) != frameSize)) {
+                userError("ARMPageRange: Cap #%lu is not a frame of the same size.", cptr + i);
+                current_syscall_error.type = seL4_InvalidCapability;
+                current_syscall_error.invalidCapNumber = 0;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+        }
+
+        if (isMap) {
+            vptr_t frameVaddr = vaddr + (i << pageBitsForSize(frameSize));
+            asid_t frame_asid = cap_frame_cap_get_capFMappedASID(frameCap);
+            vm_rights_t vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(frameCap),
+                                                rightsFromWord(rightsMask));
+            paddr_t base = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(frameCap));
+            lookupPTSlot_ret_t lu_ret;
+
+            if (frame_asid != asidInvalid) {
+                if (unlikely(frame_asid != asid)) {
+                    userError("ARMPageMapRange: Attempting to remap a frame that does not belong to the passed address space");
+                    current_syscall_error.type = seL4_InvalidCapability;
+                    current_syscall_error.invalidCapNumber = 1;
+                    status = EXCEPTION_SYSCALL_ERROR;
+                    break;
+                } else if (unlikely(cap_frame_cap_get_capFMappedAddress(frameCap) != frameVaddr)) {
+                    userError("ARMPageMapRange: Attempting to map frame into multiple addresses");
+                    current_syscall_error.type = seL4_InvalidArgument;
+                    current_syscall_error.invalidArgumentNumber = 0;
+                    status = EXCEPTION_SYSCALL_ERROR;
+                    break;
+                }
+            }
+
+            lu_ret = lookupPTSlot(vspaceRoot, frameVaddr);
+            if (unlikely(lu_ret.ptBitsLeft != pageBitsForSize(frameSize))) {
+                current_lookup_fault = lookup_fault_missing_capability_new(lu_ret.ptBitsLeft);
+                current_syscall_error.type = seL4_FailedLookup;
+                current_syscall_error.failedLookupWasSource = false;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+
+            /* only a frame that is remapped may replace a valid entry, its own */
+            if (unlikely(frame_asid == asidInvalid && pte_ptr_get_valid(lu_ret.ptSlot))) {
+                userError("ARMPageMapRange: Virtual address already mapped.");
+                current_syscall_error.type = seL4_DeleteFirst;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+
+            frameCap = cap_frame_cap_set_capFMappedASID(frameCap, asid);
+            frameCap = cap_frame_cap_set_capFMappedAddress(frameCap, frameVaddr);
+
+            setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+            tlbflush_required |= pte_ptr_get_valid(lu_ret.ptSlot);
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+            breakContiguousGroup(lu_ret.ptSlot, asid);
+#endif
+            frameSlot->cap = frameCap;
+            *lu_ret.ptSlot = makeUserPagePTE(base, vmRights, attributes, frameSize);
+
+            if (lu_ret.ptSlot != runEnd) {
+                cleanPTERange(runStart, runEnd);
+                runStart = lu_ret.ptSlot;
+            }
+            runEnd = lu_ret.ptSlot + 1;
+
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+            if (vm_attributes_get_armContiguousHint(attributes) &&
+                (isContiguousGroupEnd(lu_ret.ptSlot) || i + 1 == count)) {
+                formContiguousGroup(lu_ret.ptSlot, frameSize, asid);
+            }
+#endif
+        } else {
+            asid_t frame_asid = cap_frame_cap_get_capFMappedASID(frameCap);
+
+            setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+            if (frame_asid != asidInvalid) {
+                vptr_t frameVaddr = cap_frame_cap_get_capFMappedAddress(frameCap);
+                pte_t *ptSlot = unmapPageEntry(frameSize, frame_asid, frameVaddr,
+                                               cap_frame_cap_get_capFBasePtr(frameCap));
+
+                if (ptSlot != NULL) {
+                    if (unmapped != 0 && frame_asid != unmapASID) {
+                        cleanPTERange(runStart, runEnd);
+                        runStart = NULL;
+                        runEnd = NULL;
+                        invalidateUnmappedFrames(unmapASID, unmapped, unmappedVaddr);
+                        unmapped = 0;
+                    }
+
+                    if (ptSlot != runEnd) {
+                        cleanPTERange(runStart, runEnd);
+                        runStart = ptSlot;
+                    }
+                    runEnd = ptSlot + 1;
+
+                    unmapASID = frame_asid;
+                    unmappedVaddr = frameVaddr;
+                    unmapped++;
+                }
+
+                frameCap = cap_frame_cap_set_capFMappedAddress(frameSlot->cap, 0);
+                frameCap = cap_frame_cap_set_capFMappedASID(frameCap, asidInvalid);
+                frameSlot->cap = frameCap;
+            }
+        }
+
+        if (i + 1 < count) {
+            status = preemptionPoint();
+            if (status != EXCEPTION_NONE) {
+                advanceFrameRangeArgs(isMap, cptr, vaddr, count, i + 1, frameSize, buffer);
+                break;
+            }
+        }
+    }
+
+    cleanPTERange(runStart, runEnd);
+    if (unlikely(tlbflush_required)) {
+        assert(asid < BIT(16));
+        invalidateTLBByASID(asid);
+    }
+    invalidateUnmappedFrames(unmapASID, unmapped, unmappedVaddr);
+
+    if (status == EXCEPTION_SYSCALL_ERROR && i > 0) {
+        /* the earlier frames are done, so report the error instead of
+         * restarting the invocation */
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Running);
+    }
+
+    return status;
+}
+#endif /* CONFIG_FRAME_RANGE_INVOCATIONS */
+
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+exception_t Arch_decodeUntypedRetypeMap(object_t newType, word_t count,
+                                        cap_t vspaceCap, vptr_t vaddr)
+{
+    findVSpaceForASID_ret_t find_ret;
+    vspace_root_t *vspaceRoot;
+    vm_page_size_t frameSize;
+    word_t i;
+
+    switch (newType) {
+    case seL4_ARM_SmallPageObject:
+        frameSize = ARMSmallPage;
+        break;
+
+    case seL4_ARM_LargePageObject:
+        frameSize = ARMLargePage;
+        break;
+
+    case seL4_ARM_HugePageObject:
+        frameSize = ARMHugePage;
+        break;
+
+    default:
+        userError("Untyped RetypeMap: Only frames can be retyped and mapped.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(!isValidNativeRoot(vspaceCap))) {
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 2;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    vspaceRoot = VSPACE_PTR(cap_vspace_cap_get_capVSBasePtr(vspaceCap));
+
+    find_ret = findVSpaceForASID(cap_vspace_cap_get_capVSMappedASID(vspaceCap));
+    if (unlikely(find_ret.status != EXCEPTION_NONE)) {
+        current_syscall_error.type = seL4_FailedLookup;
+        current_syscall_error.failedLookupWasSource = false;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(find_ret.vspace_root != vspaceRoot)) {
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 2;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(!checkVPAlignment(frameSize, vaddr))) {
+        current_syscall_error.type = seL4_AlignmentError;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* written to avoid overflow in vaddr + count * frame size */
+    if (unlikely(vaddr > USER_TOP ||
+                 count > ((USER_TOP - vaddr + 1) >> pageBitsForSize(frameSize)))) {
+        userError("Untyped RetypeMap: Mapping address too high.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 6;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    for (i = 0; i < count; i++) {
+        lookupPTSlot_ret_t lu_ret = lookupPTSlot(vspaceRoot, vaddr + (i << pageBitsForSize(frameSize)));
+
+        if (unlikely(lu_ret.ptBitsLeft != pageBitsForSize(frameSize))) {
+            current_lookup_fault = lookup_fault_missing_capability_new(lu_ret.ptBitsLeft);
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (unlikely(pte_ptr_get_valid(lu_ret.ptSlot))) {
+            userError("Untyped RetypeMap: Virtual address already mapped.");
+            current_syscall_error.type = seL4_DeleteFirst;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+void Arch_performUntypedRetypeMap(cte_t *slots, word_t count, cap_t vspaceCap,
+                                  vptr_t vaddr, word_t rightsMask, word_t attr)
+{
+    vspace_root_t *vspaceRoot = VSPACE_PTR(cap_vspace_cap_get_capVSBasePtr(vspaceCap));
+    asid_t asid = cap_vspace_cap_get_capVSMappedASID(vspaceCap);
+    vm_attributes_t attributes = vmAttributesFromWord(attr);
+    pte_t *runStart = NULL, *runEnd = NULL;
+    word_t i;
+
+    for (i = 0; i < count; i++) {
+        cap_t frameCap = slots[i].cap;
+        vm_page_size_t frameSize = cap_frame_cap_get_capFSize(frameCap);
+        vptr_t frameVaddr = vaddr + (i << pageBitsForSize(frameSize));
+        vm_rights_t vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(frameCap),
+                                            rightsFromWord(rightsMask));
+        paddr_t base = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(frameCap));
+        lookupPTSlot_ret_t lu_ret = lookupPTSlot(vspaceRoot, frameVaddr);
+
+        /* the decode checked that the entries are free */
+        assert(lu_ret.ptBitsLeft == pageBitsForSize(frameSize));
+        assert(!pte_ptr_get_valid(lu_ret.ptSlot));
+
+        frameCap = cap_frame_cap_set_capFMappedASID(frameCap, asid);
+        frameCap = cap_frame_cap_set_capFMappedAddress(frameCap, frameVaddr);
+        slots[i].cap = frameCap;
+        *lu_ret.ptSlot = makeUserPagePTE(base, vmRights, attributes, frameSize);
+
+        /* merge the cache maintenance of adjacent PTEs */
+        if (lu_ret.ptSlot != runEnd) {
+            cleanPTERange(runStart, runEnd);
+            runStart = lu_ret.ptSlot;
+        }
+        runEnd = lu_ret.ptSlot + 1;
+
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+        if (vm_attributes_get_armContiguousHint(attributes) &&
+            (isContiguousGroupEnd(lu_ret.ptSlot) || i + 1 == count)) {
+            formContiguousGroup(lu_ret.ptSlot, frameSize, asid);
+        }
+#endif
+    }
+
+    cleanPTERange(runStart, runEnd);
+}
+#endif /* CONFIG_UNTYPED_RETYPE_MAP */
+
 static exception_t decodeARMFrameInvocation(word_t invLabel, word_t length,
                                             cte_t *cte, cap_t cap, bool_t call, word_t *buffer)
 {
@@ -1543,6 +2086,17 @@ static exception_t decodeARMFrameInvocation(word_t invLabel, word_t length,
 
         base = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap));
 
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+        /* a group can only be formed if the frame has the same offset in its
+         * physical group as in its virtual one */
+        if (vm_attributes_get_armContiguousHint(attributes) &&
+            unlikely(!IS_ALIGNED(vaddr ^ base, pageBitsForSize(frameSize) + PTE_CONTIGUOUS_BITS))) {
+            userError("ARMPageMap: Contiguous hint needs matching virtual and physical alignment.");
+            current_syscall_error.type = seL4_AlignmentError;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+#endif
+
         lookupPTSlot_ret_t lu_ret = lookupPTSlot(vspaceRoot, vaddr);
         if (unlikely(lu_ret.ptBitsLeft != pageBitsForSize(frameSize))) {
             current_lookup_fault = lookup_fault_missing_capability_new(lu_ret.ptBitsLeft);
@@ -1551,7 +2105,24 @@ static exception_t decodeARMFrameInvocation(word_t invLabel, word_t length,
             return EXCEPTION_SYSCALL_ERROR;
         }
 
+#if defined(CONFIG_FRAME_RANGE_INVOCATIONS) || defined(CONFIG_UNTYPED_RETYPE_MAP)
+        /* only a remap may replace a valid entry, which is then its own, as
+         * in Page_MapRange and Untyped_RetypeMap */
+        if (unlikely(frame_asid == asidInvalid && pte_ptr_get_valid(lu_ret.ptSlot))) {
+            userError("ARMPageMap: Virtual address already mapped.");
+            current_syscall_error.type = seL4_DeleteFirst;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+#endif
+
         setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+#ifdef CONFIG_ARM_CONTIGUOUS_HINT
+        if (vm_attributes_get_armContiguousHint(attributes)) {
+            return performPageInvocationMapContiguous(asid, cap, cte,
+                                                      makeUserPagePTE(base, vmRights, attributes, frameSize),
+                                                      lu_ret.ptSlot);
+        }
+#endif
         return performPageInvocationMap(asid, cap, cte,
                                         makeUserPagePTE(base, vmRights, attributes, frameSize), lu_ret.ptSlot);
     }
@@ -1648,6 +2219,11 @@ exception_t decodeARMMMUInvocation(word_t invLabel, word_t length, cptr_t cptr,
         return decodeARMPageTableInvocation(invLabel, length, cte, cap, buffer);
 
     case cap_frame_cap:
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+        if (invLabel == ARMPageMapRange || invLabel == ARMPageUnmapRange) {
+            return decodeARMFrameRangeInvocation(invLabel, length, cptr, cte, cap, buffer);
+        }
+#endif
         return decodeARMFrameInvocation(invLabel, length, cte, cap, call, buffer);
 
     case cap_asid_control_cap: {
@@ -1924,6 +2500,7 @@ exception_t benchmark_arch_map_logBuffer(word_t frame_cptr)
 #else
                              1, // UXN
 #endif
+                             0,                         /* not contiguous */
                              ksUserLogBuffer,
                              0,                         /* global */
                              1,                         /* access flag */
@@ -118,7 +118,13 @@ void VISIBLE NORETURN c_handle_interrupt(void)
 
 void NORETURN slowpath(syscall_t syscall)
 {
-    if (unlikely(syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)) {
+    NODE_LOCK_SLOWPATH;
+
+    if (unlikely((syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)
+#ifdef SYSCALL_OPTIONAL_MIN
+                 && (syscall < SYSCALL_OPTIONAL_MIN || syscall > SYSCALL_OPTIONAL_MAX)
+#endif
+                )) {
 #ifdef TRACK_KERNEL_ENTRIES
         ksKernelEntry.path = Entry_UnknownSyscall;
         /* ksKernelEntry.word word is already set to syscall */
@@ -156,7 +162,7 @@ void VISIBLE c_handle_syscall(word_t cptr, word_t msgInfo, syscall_t syscall)
 ALIGN(L1_CACHE_LINE_SIZE)
 void VISIBLE c_handle_fastpath_call(word_t cptr, word_t msgInfo)
 {
-    NODE_LOCK_SYS;
+    NODE_LOCK_FASTPATH;
 
     c_entry_hook();
 #ifdef TRACK_KERNEL_ENTRIES
@@ -186,6 +192,22 @@ void VISIBLE c_handle_fastpath_signal(word_t cptr, word_t msgInfo)
 #endif /* CONFIG_SIGNAL_FASTPATH */
 #endif /* CONFIG_KERNEL_MCS */
 
+#ifdef CONFIG_WAIT_FASTPATH
+ALIGN(L1_CACHE_LINE_SIZE)
+void VISIBLE c_handle_fastpath_wait(word_t cptr, word_t msgInfo, syscall_t syscall)
+{
+    NODE_LOCK_SYS;
+
+    c_entry_hook();
+#ifdef TRACK_KERNEL_ENTRIES
+    benchmark_debug_syscall_start(cptr, msgInfo, syscall);
+    ksKernelEntry.is_fastpath = 1;
+#endif /* DEBUG */
+    fastpath_wait(cptr, syscall);
+    UNREACHABLE();
+}
+#endif /* CONFIG_WAIT_FASTPATH */
+
 ALIGN(L1_CACHE_LINE_SIZE)
 #ifdef CONFIG_KERNEL_MCS
 void VISIBLE c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo, word_t reply)
@@ -193,7 +215,7 @@ void VISIBLE c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo, word_t re
 void VISIBLE c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo)
 #endif
 {
-    NODE_LOCK_SYS;
+    NODE_LOCK_FASTPATH;
 
     c_entry_hook();
 #ifdef TRACK_KERNEL_ENTRIES
@@ -35,6 +35,11 @@ volatile struct gic_dist_map *const gic_dist = (volatile struct gic_dist_map *)(
 volatile void *const gicr_base = (volatile uint8_t *)(GICR_PPTR);
 
 word_t active_irq[CONFIG_MAX_NUM_NODES] = {IRQ_NONE};
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+word_t gic_deferred_deactivate[GIC_IRQ_BITMAP_WORDS];
+word_t gic_pending_deactivate[GIC_IRQ_BITMAP_WORDS];
+word_t gic_num_pending_deactivate;
+#endif
 volatile struct gic_rdist_map *gic_rdist_map[CONFIG_MAX_NUM_NODES] = { 0 };
 volatile struct gic_rdist_sgi_ppi_map *gic_rdist_sgi_ppi_map[CONFIG_MAX_NUM_NODES] = { 0 };
 
@@ -276,10 +281,18 @@ BOOT_CODE static void cpu_iface_init(void)
     /* Set priority mask register: ICC_PMR_EL1 */
     SYSTEM_WRITE_WORD(ICC_PMR_EL1, DEFAULT_PMR_VALUE);
 
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    /* EOI only drops priority, deactivation is a separate write to
+     * ICC_DIR_EL1: ICC_CTLR_EL1 */
+    SYSTEM_READ_WORD(ICC_CTLR_EL1, icc_ctlr);
+    icc_ctlr |= GICC_CTLR_EL1_EOImode_drop;
+    SYSTEM_WRITE_WORD(ICC_CTLR_EL1, icc_ctlr);
+#else
     /* EOI drops priority and deactivates the interrupt: ICC_CTLR_EL1 */
     SYSTEM_READ_WORD(ICC_CTLR_EL1, icc_ctlr);
     icc_ctlr &= ~GICC_CTLR_EL1_EOImode_drop;
     SYSTEM_WRITE_WORD(ICC_CTLR_EL1, icc_ctlr);
+#endif
 
     /* Enable Group1 interrupts: ICC_IGRPEN1_EL1 */
     SYSTEM_WRITE_WORD(ICC_IGRPEN1_EL1, 1);
@@ -145,7 +145,13 @@ void VISIBLE NORETURN c_handle_exception(void)
 
 void VISIBLE NORETURN slowpath(syscall_t syscall)
 {
-    if (unlikely(syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)) {
+    NODE_LOCK_SLOWPATH;
+
+    if (unlikely((syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)
+#ifdef SYSCALL_OPTIONAL_MIN
+                 && (syscall < SYSCALL_OPTIONAL_MIN || syscall > SYSCALL_OPTIONAL_MAX)
+#endif
+                )) {
 #ifdef TRACK_KERNEL_ENTRIES
         ksKernelEntry.path = Entry_UnknownSyscall;
 #endif /* TRACK_KERNEL_ENTRIES */
@@ -172,7 +178,7 @@ void VISIBLE c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo, word_t re
 void VISIBLE c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo)
 #endif
 {
-    NODE_LOCK_SYS;
+    NODE_LOCK_FASTPATH;
 
     c_entry_hook();
 #ifdef TRACK_KERNEL_ENTRIES
@@ -190,7 +196,7 @@ void VISIBLE c_handle_fastpath_reply_recv(word_t cptr, word_t msgInfo)
 ALIGN(L1_CACHE_LINE_SIZE)
 void VISIBLE c_handle_fastpath_call(word_t cptr, word_t msgInfo)
 {
-    NODE_LOCK_SYS;
+    NODE_LOCK_FASTPATH;
 
     c_entry_hook();
 #ifdef TRACK_KERNEL_ENTRIES
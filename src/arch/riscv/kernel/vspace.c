@@ -382,6 +382,23 @@ word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread)
     }
 }
 
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap)
+{
+    if (unlikely(cap_get_capType(cap) != cap_frame_cap)) {
+        return NULL;
+    }
+    if (unlikely(cap_frame_cap_get_capFIsDevice(cap))) {
+        return NULL;
+    }
+    if (unlikely(cap_frame_cap_get_capFVMRights(cap) != VMReadWrite)) {
+        return NULL;
+    }
+
+    return (word_t *)cap_frame_cap_get_capFBasePtr(cap);
+}
+#endif /* CONFIG_BATCH_INVOCATION */
+
 static inline pte_t *getPPtrFromHWPTE(pte_t *pte)
 {
     return PTE_PTR(ptrFromPAddr(pte_ptr_get_ppn(pte) << seL4_PageTableBits));
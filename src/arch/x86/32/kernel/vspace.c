@@ -624,6 +624,14 @@ void hwASIDInvalidate(asid_t asid, vspace_root_t *vspace)
     return;
 }
 
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+void modeInvalidateTranslationASID(vspace_root_t *vspace, asid_t asid)
+{
+    /* 32-bit does not have PCID, flush all non-global translations */
+    invalidateTLB(SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+}
+#endif
+
 exception_t decodeX86ModeMMUInvocation(
     word_t invLabel,
     word_t length,
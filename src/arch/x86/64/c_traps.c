@@ -10,6 +10,7 @@
 #include <kernel/traps.h>
 #include <arch/machine/debug.h>
 #include <kernel/stack.h>
+#include <mode/smp/ipi.h>
 
 #include <api/syscall.h>
 
@@ -208,6 +209,13 @@ static void NORETURN restore_vmx(void)
 
 void VISIBLE NORETURN restore_user_context(void)
 {
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    /* other cores must not run with stale translations once the lock is
+     * released */
+    if (unlikely(MODE_NODE_STATE(x64KSShootdowns).count != 0)) {
+        shootdownFlush();
+    }
+#endif
     NODE_UNLOCK_IF_HELD;
     c_exit_hook();
 
@@ -1066,11 +1066,108 @@ static void flushPDPT(vspace_root_t *vspace, word_t vptr, pdpte_t *pdpt, asid_t
     return;
 }
 
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+/* Collect the pages mapped below a paging structure that is about to be
+ * unmapped. Both the number of pages and the number of tables scanned are
+ * bounded by the flush limit, so that a sparse structure is not more costly
+ * to scan than invalidating the whole PCID. */
+static bool_t collectPTFlush(tlb_flush_list_t *list, word_t *tables, pte_t *pt, vptr_t vptr)
+{
+    word_t i;
+
+    if (*tables == CONFIG_X86_TLB_RANGE_FLUSH_LIMIT) {
+        return false;
+    }
+    (*tables)++;
+
+    for (i = 0; i < BIT(PT_INDEX_BITS); i++) {
+        if (pte_ptr_get_present(pt + i) &&
+            !tlbFlushListAdd(list, vptr + (i << PT_INDEX_OFFSET))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+static bool_t collectPDFlush(tlb_flush_list_t *list, word_t *tables, pde_t *pd, vptr_t vptr)
+{
+    word_t i;
+
+    if (*tables == CONFIG_X86_TLB_RANGE_FLUSH_LIMIT) {
+        return false;
+    }
+    (*tables)++;
+
+    for (i = 0; i < BIT(PD_INDEX_BITS); i++) {
+        pde_t *pdSlot = pd + i;
+        vptr_t vaddr = vptr + (i << PD_INDEX_OFFSET);
+
+        if (pde_ptr_get_page_size(pdSlot) == pde_pde_large) {
+            if (pde_pde_large_ptr_get_present(pdSlot) && !tlbFlushListAdd(list, vaddr)) {
+                return false;
+            }
+        } else if (pde_pde_pt_ptr_get_present(pdSlot)) {
+            pte_t *pt = paddr_to_pptr(pde_pde_pt_ptr_get_pt_base_address(pdSlot));
+            if (!collectPTFlush(list, tables, pt, vaddr)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static bool_t collectPDPTFlush(tlb_flush_list_t *list, word_t *tables, pdpte_t *pdpt, vptr_t vptr)
+{
+    word_t i;
+
+    if (*tables == CONFIG_X86_TLB_RANGE_FLUSH_LIMIT) {
+        return false;
+    }
+    (*tables)++;
+
+    for (i = 0; i < BIT(PDPT_INDEX_BITS); i++) {
+        pdpte_t *pdptSlot = pdpt + i;
+        vptr_t vaddr = vptr + (i << PDPT_INDEX_OFFSET);
+
+        if (pdpte_ptr_get_page_size(pdptSlot) == pdpte_pdpte_1g) {
+            if (pdpte_pdpte_1g_ptr_get_present(pdptSlot) && !tlbFlushListAdd(list, vaddr)) {
+                return false;
+            }
+        } else if (pdpte_pdpte_pd_ptr_get_present(pdptSlot)) {
+            pde_t *pd = paddr_to_pptr(pdpte_pdpte_pd_ptr_get_pd_base_address(pdptSlot));
+            if (!collectPDFlush(list, tables, pd, vaddr)) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+/* Invalidate the collected pages after the structure has been unmapped, so
+ * that no other core can walk into it again. Invalidating a single address
+ * also drops all paging structure cache entries of the PCID, so one address
+ * is invalidated even if nothing was mapped. */
+static void flushCollected(vspace_root_t *vspace, tlb_flush_list_t *list, vptr_t vptr, asid_t asid)
+{
+    if (list->count == 0) {
+        tlbFlushListAdd(list, vptr);
+    }
+    invalidatePCIDList(asid, list, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+}
+#endif /* CONFIG_X86_RANGED_TLB_FLUSH */
+
 void hwASIDInvalidate(asid_t asid, vspace_root_t *vspace)
 {
     invalidateASID(vspace, asid, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
 }
 
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+void modeInvalidateTranslationASID(vspace_root_t *vspace, asid_t asid)
+{
+    invalidateASID(vspace, asid, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+}
+#endif
+
 void unmapPageDirectory(asid_t asid, vptr_t vaddr, pde_t *pd)
 {
     findVSpaceForASID_ret_t find_ret;
@@ -1093,6 +1190,17 @@ void unmapPageDirectory(asid_t asid, vptr_t vaddr, pde_t *pd)
         return;
     }
 
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    tlb_flush_list_t list = { .count = 0 };
+    word_t tables = 0;
+
+    if (collectPDFlush(&list, &tables, pd, vaddr)) {
+        *lu_ret.pdptSlot = makeUserPDPTEInvalid();
+        flushCollected(find_ret.vspace_root, &list, vaddr, asid);
+        return;
+    }
+#endif
+
     flushPD(find_ret.vspace_root, vaddr, pd, asid);
 
     *lu_ret.pdptSlot = makeUserPDPTEInvalid();
@@ -1264,6 +1372,17 @@ static void unmapPDPT(asid_t asid, vptr_t vaddr, pdpte_t *pdpt)
         return;
     }
 
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    tlb_flush_list_t list = { .count = 0 };
+    word_t tables = 0;
+
+    if (collectPDPTFlush(&list, &tables, pdpt, vaddr)) {
+        *pml4Slot = makeUserPML4EInvalid();
+        flushCollected(find_ret.vspace_root, &list, vaddr, asid);
+        return;
+    }
+#endif
+
     flushPDPT(find_ret.vspace_root, vaddr, pdpt, asid);
 
     *pml4Slot = makeUserPML4EInvalid();
@@ -27,5 +27,8 @@ UP_STATE_DEFINE(word_t, x64KSCurrentUserCR3);
 #else
 UP_STATE_DEFINE(cr3_t, x64KSCurrentCR3);
 #endif
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+UP_STATE_DEFINE(shootdown_queue_t, x64KSShootdowns);
+#endif
 
 word_t x64KSIRQStack[CONFIG_MAX_NUM_NODES][IRQ_STACK_SIZE + 2] ALIGN(64) VISIBLE SKIM_BSS;
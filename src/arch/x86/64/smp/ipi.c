@@ -5,11 +5,110 @@
  */
 
 #include <config.h>
+#include <model/statedata.h>
 #include <mode/smp/ipi.h>
 #include <mode/kernel/tlb.h>
 
 #ifdef ENABLE_SMP_SUPPORT
 
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+static void shootdownsLocal(shootdown_t *shootdowns, word_t count)
+{
+    for (word_t i = 0; i < count; i++) {
+        shootdown_t *shootdown = &shootdowns[i];
+
+        switch (shootdown->type) {
+        case shootdown_pcid:
+            invalidateLocalPCID(shootdown->args[0], (void *)shootdown->args[1], shootdown->args[2]);
+            break;
+
+        case shootdown_translation:
+            invalidateLocalTranslationSingleASID(shootdown->args[0], shootdown->args[1]);
+            break;
+
+        case shootdown_asid:
+            invalidateLocalASID((vspace_root_t *)shootdown->args[0], shootdown->args[1]);
+            break;
+
+        case shootdown_page_structure_cache:
+            invalidateLocalPageStructureCacheASID(shootdown->args[0], shootdown->args[1]);
+            break;
+
+        default:
+            fail("Invalid shootdown");
+        }
+    }
+}
+
+/* All queued invalidations are performed after the paging structures have
+ * been updated, so an invalidation is redundant if the same one is already
+ * queued, or if it is for a single address of an ASID that is queued to be
+ * invalidated as a whole. */
+static bool_t shootdownIsQueued(shootdown_queue_t *queue, word_t type,
+                                word_t arg0, word_t arg1, word_t arg2)
+{
+    for (word_t i = 0; i < queue->count; i++) {
+        shootdown_t *queued = &queue->entries[i];
+
+        if (queued->type == type && queued->args[0] == arg0 &&
+            queued->args[1] == arg1 && queued->args[2] == arg2) {
+            return true;
+        }
+        if (queued->type == shootdown_asid && type == shootdown_translation &&
+            queued->args[1] == arg1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void shootdownQueue(word_t type, word_t arg0, word_t arg1, word_t arg2, word_t mask)
+{
+    shootdown_queue_t *queue = &MODE_NODE_STATE(x64KSShootdowns);
+
+    mask &= ~BIT(getCurrentCPUIndex());
+    if (mask == 0) {
+        return;
+    }
+
+    if (queue->count == SHOOTDOWN_QUEUE_SIZE) {
+        shootdownFlush();
+    }
+
+    queue->requests++;
+    queue->mask |= mask;
+    if (shootdownIsQueued(queue, type, arg0, arg1, arg2)) {
+        return;
+    }
+
+    queue->entries[queue->count].type = type;
+    queue->entries[queue->count].args[0] = arg0;
+    queue->entries[queue->count].args[1] = arg1;
+    queue->entries[queue->count].args[2] = arg2;
+    queue->count++;
+}
+
+/* The remote cores read the entries from this core's queue, which is not
+ * changed before all of them have completed the remote call. */
+void shootdownFlush(void)
+{
+    shootdown_queue_t *queue = &MODE_NODE_STATE(x64KSShootdowns);
+
+    if (queue->count == 0) {
+        return;
+    }
+
+    doRemoteMaskOp2Arg((IpiRemoteCall_t)IpiRemoteCall_Shootdowns, (word_t)queue->entries,
+                       queue->count, queue->mask);
+    queue->ipisSent++;
+    queue->ipisAvoided += queue->requests - 1;
+
+    queue->count = 0;
+    queue->mask = 0;
+    queue->requests = 0;
+}
+#endif /* CONFIG_X86_DEFERRED_SHOOTDOWN */
+
 void Mode_handleRemoteCall(IpiModeRemoteCall_t call, word_t arg0, word_t arg1, word_t arg2)
 {
     switch (call) {
@@ -21,6 +120,18 @@ void Mode_handleRemoteCall(IpiModeRemoteCall_t call, word_t arg0, word_t arg1, w
         invalidateLocalASID((vspace_root_t *)arg0, arg1);
         break;
 
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    case IpiRemoteCall_InvalidatePCIDList:
+        invalidateLocalPCIDList(arg0, arg1, (vptr_t *)arg2);
+        break;
+#endif
+
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    case IpiRemoteCall_Shootdowns:
+        shootdownsLocal((shootdown_t *)arg0, arg1);
+        break;
+#endif
+
     default:
         fail("Invalid remote call");
     }
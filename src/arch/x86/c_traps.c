@@ -102,6 +102,7 @@ void VISIBLE NORETURN c_handle_interrupt(int irq, int syscall)
 
 void NORETURN slowpath(syscall_t syscall)
 {
+    NODE_LOCK_SLOWPATH;
 
 #ifdef CONFIG_VTX
     if (syscall == SysVMEnter && NODE_STATE(ksCurThread)->tcbArch.tcbVCPU) {
@@ -121,7 +122,11 @@ void NORETURN slowpath(syscall_t syscall)
     }
 #endif
     /* check for undefined syscall */
-    if (unlikely(syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)) {
+    if (unlikely((syscall < SYSCALL_MIN || syscall > SYSCALL_MAX)
+#ifdef SYSCALL_OPTIONAL_MIN
+                 && (syscall < SYSCALL_OPTIONAL_MIN || syscall > SYSCALL_OPTIONAL_MAX)
+#endif
+                )) {
 #ifdef TRACK_KERNEL_ENTRIES
         ksKernelEntry.path = Entry_UnknownSyscall;
         /* ksKernelEntry.word word is already set to syscall */
@@ -153,7 +158,15 @@ void VISIBLE NORETURN c_handle_syscall(word_t cptr, word_t msgInfo, syscall_t sy
         x86_enable_ibrs();
     }
 
+#if defined(CONFIG_FASTPATH) && defined(CONFIG_SMP_NODE_LOCKS)
+    if (syscall == (syscall_t)SysCall || syscall == (syscall_t)SysReplyRecv) {
+        NODE_LOCK_FASTPATH;
+    } else {
+        NODE_LOCK_SYS;
+    }
+#else
     NODE_LOCK_SYS;
+#endif
 
     c_entry_hook();
 
@@ -182,6 +195,16 @@ void VISIBLE NORETURN c_handle_syscall(word_t cptr, word_t msgInfo, syscall_t sy
 #endif
         UNREACHABLE();
     }
+#ifdef CONFIG_WAIT_FASTPATH
+    if (syscall == (syscall_t)SysRecv || syscall == (syscall_t)SysNBRecv
+#ifdef CONFIG_KERNEL_MCS
+        || syscall == (syscall_t)SysWait || syscall == (syscall_t)SysNBWait
+#endif
+       ) {
+        fastpath_wait(cptr, syscall);
+        UNREACHABLE();
+    }
+#endif /* CONFIG_WAIT_FASTPATH */
 #endif /* CONFIG_FASTPATH */
     slowpath(syscall);
     UNREACHABLE();
@@ -128,6 +128,24 @@ config_option(
     DEPENDS "KernelSel4ArchX86_64"
     DEFAULT_DISABLED OFF
 )
+config_option(
+    KernelX86RangedTLBFlush X86_RANGED_TLB_FLUSH
+    "When unmapping a page table, page directory or PDPT, invalidate the translations \
+    of the pages mapped below it one address at a time and pass the addresses to other \
+    cores in a single remote call, instead of invalidating the whole PCID. Structures \
+    with more than KernelX86TLBRangeFlushLimit mapped pages still invalidate the whole PCID."
+    DEFAULT OFF
+    DEPENDS "KernelSel4ArchX86_64;NOT KernelVerificationBuild"
+    DEFAULT_DISABLED OFF
+)
+config_string(
+    KernelX86TLBRangeFlushLimit X86_TLB_RANGE_FLUSH_LIMIT
+    "Maximum number of pages, and of page tables scanned to find them, for which an \
+    unmap invalidates translations one address at a time. At most 64."
+    DEFAULT 16
+    DEPENDS "KernelX86RangedTLBFlush" UNDEF_DISABLED
+    UNQUOTE
+)
 
 config_choice(
     KernelSyscall
@@ -8,6 +8,8 @@
 #include <machine/io.h>
 #include <arch/machine.h>
 #include <arch/kernel/apic.h>
+#include <arch/machine/timer.h>
+#include <mode/util.h>
 #include <linker.h>
 #include <plat/machine/devices.h>
 #include <plat/machine/pit.h>
@@ -95,6 +97,11 @@ BOOT_CODE bool_t apic_init(bool_t mask_legacy_irqs)
     /* initialise APIC timer */
     apic_write_reg(APIC_TIMER_DIVIDE, 0xb); /* divisor = 1 */
     apic_write_reg(APIC_TIMER_COUNT, apic_khz * CONFIG_TIMER_TICK_MS);
+#ifdef CONFIG_TICKLESS
+    x86KSapicTickCycles = apic_khz * CONFIG_TIMER_TICK_MS;
+    ARCH_NODE_STATE(x86KStimerCount) = x86KSapicTickCycles;
+    ARCH_NODE_STATE(x86KStimerOffset) = 0;
+#endif
 #endif
 
     /* enable APIC using SVR register */
@@ -141,6 +148,8 @@ BOOT_CODE bool_t apic_init(bool_t mask_legacy_irqs)
 #ifdef CONFIG_KERNEL_MCS
     uint32_t timer_mode = x86KSapicRatio == 0 ? APIC_TIMER_MODE_TSC_DEADLINE :
                           APIC_TIMER_MODE_ONE_SHOT;
+#elif defined(CONFIG_TICKLESS)
+    uint32_t timer_mode = APIC_TIMER_MODE_ONE_SHOT;
 #else
     uint32_t timer_mode = 1;
 #endif
@@ -175,3 +184,57 @@ void apic_ack_active_interrupt(void)
 {
     apic_write_reg(APIC_EOI, 0);
 }
+
+#ifdef CONFIG_TICKLESS
+/* APIC cycles since the last tick that has been accounted */
+static uint64_t apic_cycles_since_tick(void)
+{
+    uint32_t count = ARCH_NODE_STATE(x86KStimerCount);
+
+    if (count == 0) {
+        return 0;
+    }
+    return ARCH_NODE_STATE(x86KStimerOffset) + count - apic_read_reg(APIC_TIMER_CURRENT);
+}
+
+word_t getElapsedTicks(void)
+{
+    word_t ticks = div64(apic_cycles_since_tick(), x86KSapicTickCycles);
+
+    ARCH_NODE_STATE(x86KStimerOffset) -= (uint64_t)ticks * x86KSapicTickCycles;
+    return ticks;
+}
+
+void setNextTick(word_t ticks)
+{
+    uint64_t cycles, since;
+    uint32_t count;
+
+    if (ticks == 0) {
+        if (ARCH_NODE_STATE(x86KStimerCount) != 0) {
+            apic_write_reg(APIC_TIMER_COUNT, 0);
+            ARCH_NODE_STATE(x86KStimerCount) = 0;
+            ARCH_NODE_STATE(x86KStimerOffset) = 0;
+        }
+        return;
+    }
+
+    /* the count register is 32 bits, wake up early for longer timeouts */
+    ticks = MIN(ticks, UINT32_MAX / x86KSapicTickCycles);
+    cycles = (uint64_t)ticks * x86KSapicTickCycles;
+
+    /* Leave the timer alone if it already fires then */
+    if (ARCH_NODE_STATE(x86KStimerCount) != 0 &&
+        ARCH_NODE_STATE(x86KStimerOffset) + ARCH_NODE_STATE(x86KStimerCount) == cycles) {
+        return;
+    }
+
+    /* Count from the last tick that has been accounted rather than from
+     * now, so that ticks do not drift every time the timer is reprogrammed */
+    since = apic_cycles_since_tick();
+    count = since < cycles ? cycles - since : 1;
+    apic_write_reg(APIC_TIMER_COUNT, count);
+    ARCH_NODE_STATE(x86KStimerCount) = count;
+    ARCH_NODE_STATE(x86KStimerOffset) = since;
+}
+#endif /* CONFIG_TICKLESS */
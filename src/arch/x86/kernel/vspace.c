@@ -9,6 +9,8 @@
 #include <machine/io.h>
 #include <kernel/boot.h>
 #include <model/statedata.h>
+#include <model/preemption.h>
+#include <object/untyped.h>
 #include <arch/kernel/vspace.h>
 #include <arch/api/invocation.h>
 #include <arch/kernel/tlb_bitmap.h>
@@ -121,6 +123,23 @@ word_t *PURE lookupIPCBuffer(bool_t isReceiver, tcb_t *thread)
     }
 }
 
+#ifdef CONFIG_BATCH_INVOCATION
+word_t *PURE lookupBatchBuffer(cap_t cap)
+{
+    if (unlikely(cap_get_capType(cap) != cap_frame_cap)) {
+        return NULL;
+    }
+    if (unlikely(cap_frame_cap_get_capFIsDevice(cap))) {
+        return NULL;
+    }
+    if (unlikely(cap_frame_cap_get_capFVMRights(cap) != VMReadWrite)) {
+        return NULL;
+    }
+
+    return (word_t *)cap_frame_cap_get_capFBasePtr(cap);
+}
+#endif /* CONFIG_BATCH_INVOCATION */
+
 bool_t CONST isValidVTableRoot(cap_t cap)
 {
     return isValidNativeRoot(cap);
@@ -694,6 +713,26 @@ void flushTable(vspace_root_t *vspace, word_t vptr, pte_t *pt, asid_t asid)
 
     /* check if page table belongs to current address space */
     threadRoot = TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbVTable)->cap;
+
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    tlb_flush_list_t list = { .count = 0 };
+
+    /* pass all mappings to the other cores in one remote call if they fit */
+    for (i = 0; i < BIT(PT_INDEX_BITS); i++) {
+        if (pte_get_present(pt[i]) && !tlbFlushListAdd(&list, vptr + (i << PAGE_BITS))) {
+            break;
+        }
+    }
+    if (i == BIT(PT_INDEX_BITS)) {
+        if (list.count != 0 &&
+            (config_set(CONFIG_SUPPORT_PCID) || (isValidNativeRoot(threadRoot)
+                                                 && (vspace_root_t *)pptr_of_cap(threadRoot) == vspace))) {
+            invalidatePCIDList(asid, &list, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+        }
+        return;
+    }
+#endif
+
     /* find valid mappings */
     for (i = 0; i < BIT(PT_INDEX_BITS); i++) {
         if (pte_get_present(pt[i])) {
@@ -707,7 +746,9 @@ void flushTable(vspace_root_t *vspace, word_t vptr, pte_t *pt, asid_t asid)
 }
 
 
-void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
+/* Remove the mapping of pptr at vptr without invalidating its translation.
+ * Returns the VSpace the mapping was removed from, or NULL if there was none. */
+static vspace_root_t *unmapPageEntry(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
 {
     findVSpaceForASID_ret_t find_ret;
     lookupPTSlot_ret_t  lu_ret;
@@ -716,19 +757,19 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
 
     find_ret = findVSpaceForASID(asid);
     if (find_ret.status != EXCEPTION_NONE) {
-        return;
+        return NULL;
     }
 
     switch (page_size) {
     case X86_SmallPage:
         lu_ret = lookupPTSlot(find_ret.vspace_root, vptr);
         if (lu_ret.status != EXCEPTION_NONE) {
-            return;
+            return NULL;
         }
         if (!(pte_ptr_get_present(lu_ret.ptSlot)
               && (pte_ptr_get_page_base_address(lu_ret.ptSlot)
                   == pptr_to_paddr(pptr)))) {
-            return;
+            return NULL;
         }
         *lu_ret.ptSlot = makeUserPTEInvalid();
         break;
@@ -736,27 +777,35 @@ void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
     case X86_LargePage:
         pd_ret = lookupPDSlot(find_ret.vspace_root, vptr);
         if (pd_ret.status != EXCEPTION_NONE) {
-            return;
+            return NULL;
         }
         pde = pd_ret.pdSlot;
         if (!(pde_ptr_get_page_size(pde) == pde_pde_large
               && pde_pde_large_ptr_get_present(pde)
               && (pde_pde_large_ptr_get_page_base_address(pde)
                   == pptr_to_paddr(pptr)))) {
-            return;
+            return NULL;
         }
         *pde = makeUserPDEInvalid();
         break;
 
     default:
         if (!modeUnmapPage(page_size, find_ret.vspace_root, vptr, pptr)) {
-            return;
+            return NULL;
         }
         break;
     }
 
-    invalidateTranslationSingleASID(vptr, asid,
-                                    SMP_TERNARY(tlb_bitmap_get(find_ret.vspace_root), 0));
+    return find_ret.vspace_root;
+}
+
+void unmapPage(vm_page_size_t page_size, asid_t asid, vptr_t vptr, void *pptr)
+{
+    vspace_root_t *vspace = unmapPageEntry(page_size, asid, vptr, pptr);
+
+    if (vspace != NULL) {
+        invalidateTranslationSingleASID(vptr, asid, SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    }
 }
 
 void unmapPageTable(asid_t asid, vptr_t vaddr, pte_t *pt)
@@ -1105,6 +1154,450 @@ exception_t decodeX86FrameInvocation(
     }
 }
 
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+/* Rewrite the arguments of a preempted range invocation to describe the frames
+ * from done onwards, so that the restarted invocation continues with them. */
+static void advanceFrameRangeArgs(bool_t isMap, cptr_t cptr, word_t vaddr, word_t count,
+                                  word_t done, vm_page_size_t frameSize, word_t *buffer)
+{
+    tcb_t *thread = NODE_STATE(ksCurThread);
+
+    setRegister(thread, capRegister, cptr + done);
+    if (isMap) {
+        setMR(thread, buffer, 0, vaddr + (done << pageBitsForSize(frameSize)));
+        setMR(thread, buffer, 3, count - done);
+    } else {
+        setMR(thread, buffer, 0, count - done);
+    }
+}
+
+/* Translations that an unmap range invocation still has to invalidate, all of
+ * pages unmapped from the same address space. */
+typedef struct frame_range_flush {
+    vspace_root_t *vspace;
+    asid_t asid;
+    word_t count;
+    vptr_t vptr;
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    tlb_flush_list_t list;
+#endif
+} frame_range_flush_t;
+
+static void flushFrameRange(frame_range_flush_t *flush)
+{
+    word_t mask;
+
+    if (flush->count == 0) {
+        return;
+    }
+
+    mask = SMP_TERNARY(tlb_bitmap_get(flush->vspace), 0);
+    if (flush->count == 1) {
+        invalidateTranslationSingleASID(flush->vptr, flush->asid, mask);
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    } else if (flush->count == flush->list.count) {
+        invalidatePCIDList(flush->asid, &flush->list, mask);
+#endif
+    } else {
+        modeInvalidateTranslationASID(flush->vspace, flush->asid);
+    }
+
+    flush->count = 0;
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+    flush->list.count = 0;
+#endif
+}
+
+/* Unmap a frame mapped into a VSpace and queue the invalidation of its
+ * translation, which is shared by the frames that follow it in the range. */
+static void unmapRangeFrame(frame_range_flush_t *flush, cap_t cap, cte_t *ctSlot)
+{
+    asid_t asid = cap_frame_cap_get_capFMappedASID(cap);
+    vptr_t vptr = cap_frame_cap_get_capFMappedAddress(cap);
+    vspace_root_t *vspace;
+
+    vspace = unmapPageEntry(cap_frame_cap_get_capFSize(cap), asid, vptr,
+                            (void *)cap_frame_cap_get_capFBasePtr(cap));
+    if (vspace != NULL) {
+        if (flush->count != 0 && flush->asid != asid) {
+            flushFrameRange(flush);
+        }
+        flush->vspace = vspace;
+        flush->asid = asid;
+        flush->vptr = vptr;
+        flush->count++;
+#ifdef CONFIG_X86_RANGED_TLB_FLUSH
+        /* a full list leaves count above list.count, which flushes the PCID */
+        tlbFlushListAdd(&flush->list, vptr);
+#endif
+    }
+
+    cap_frame_cap_ptr_set_capFMappedAddress(&ctSlot->cap, 0);
+    cap_frame_cap_ptr_set_capFMappedASID(&ctSlot->cap, asidInvalid);
+    cap_frame_cap_ptr_set_capFMapType(&ctSlot->cap, X86_MappingNone);
+}
+
+/* Map or unmap the frames at count consecutive cptrs starting at cptr. Frames
+ * are decoded and performed one at a time, so an error leaves the frames before
+ * the failing one mapped or unmapped. Every frame, including one that is already
+ * in the requested state, counts towards preemption, and a preempted invocation
+ * is restarted with its arguments advanced past the completed frames. */
+static exception_t decodeX86FrameRangeInvocation(
+    word_t invLabel,
+    word_t length,
+    cptr_t cptr,
+    cte_t *cte,
+    cap_t cap,
+    word_t *buffer
+)
+{
+    word_t          vaddr = 0;
+    word_t          count;
+    word_t          i;
+    word_t          w_rightsMask = 0;
+    cap_t           vspaceCap;
+    vspace_root_t  *vspace = NULL;
+    vm_attributes_t vmAttr = vmAttributesFromWord(0);
+    vm_page_size_t  frameSize;
+    asid_t          asid = asidInvalid;
+    bool_t          isMap = invLabel == X86PageMapRange;
+    bool_t          flush = false;
+    frame_range_flush_t unmapFlush = { .count = 0 };
+    exception_t     status = EXCEPTION_NONE;
+
+    frameSize = cap_frame_cap_get_capFSize(cap);
+
+    if (isMap) {
+        findVSpaceForASID_ret_t find_ret;
+
+        if (length < 4 || current_extra_caps.excaprefs[0] == NULL) {
+            current_syscall_error.type = seL4_TruncatedMessage;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        vaddr = getSyscallArg(0, buffer);
+        w_rightsMask = getSyscallArg(1, buffer);
+        vmAttr = vmAttributesFromWord(getSyscallArg(2, buffer));
+        count = getSyscallArg(3, buffer);
+        vspaceCap = current_extra_caps.excaprefs[0]->cap;
+
+        if (!isValidNativeRoot(vspaceCap)) {
+            userError("X86FrameMapRange: Attempting to map frames into invalid page directory cap.");
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 1;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        vspace = (vspace_root_t *)pptr_of_cap(vspaceCap);
+        asid = cap_get_capMappedASID(vspaceCap);
+
+        find_ret = findVSpaceForASID(asid);
+        if (find_ret.status != EXCEPTION_NONE) {
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (find_ret.vspace_root != vspace) {
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 1;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (frameSize != X86_SmallPage && frameSize != X86_LargePage) {
+            userError("X86FrameMapRange: Only small and large pages can be mapped as a range.");
+            current_syscall_error.type = seL4_IllegalOperation;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (!checkVPAlignment(frameSize, vaddr)) {
+            current_syscall_error.type = seL4_AlignmentError;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        /* written to avoid overflow in vaddr + count * frame size */
+        if (vaddr > USER_TOP || count > ((USER_TOP - vaddr + 1) >> pageBitsForSize(frameSize))) {
+            userError("X86FrameMapRange: Mapping address too high.");
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 0;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    } else {
+        if (length < 1) {
+            current_syscall_error.type = seL4_TruncatedMessage;
+
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        count = getSyscallArg(0, buffer);
+    }
+
+    if (count == 0) {
+        userError("X86FrameRange: Empty range.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = isMap ? 3 : 0;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    for (i = 0; i < count; i++) {
+        cap_t frameCap = cap;
+        cte_t *frameSlot = cte;
+
+        if (i > 0) {
+            lookupCapAndSlot_ret_t lu_ret = lookupCapAndSlot(NODE_STATE(ksCurThread), cptr + i);
+            if (lu_ret.status != EXCEPTION_NONE) {
+                userError("X86FrameRange: Invalid cap #%lu.", cptr + i);
+                current_syscall_error.type = seL4_FailedLookup;
+                current_syscall_error.failedLookupWasSource = true;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+            frameCap = lu_ret.cap;
+            frameSlot = lu_ret.slot;
+
+            if (cap_get_capType(frameCap) != cap_frame_cap ||
+                cap_frame_cap_get_capFSize(frameCap) != frameSize) {
+                userError("X86FrameRange: Cap #%lu is not a frame of the same size.", cptr + i);
+                current_syscall_error.type = seL4_InvalidCapability;
+                current_syscall_error.invalidCapNumber = 0;
+                status = EXCEPTION_SYSCALL_ERROR;
+                break;
+            }
+        }
+
+        if (isMap) {
+            word_t frameVaddr = vaddr + (i << pageBitsForSize(frameSize));
+            paddr_t paddr = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(frameCap));
+            vm_rights_t vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(frameCap),
+                                                rightsFromWord(w_rightsMask));
+
+            if (cap_frame_cap_get_capFMappedASID(frameCap) != asidInvalid) {
+                if (cap_frame_cap_get_capFMappedASID(frameCap) != asid) {
+                    current_syscall_error.type = seL4_InvalidCapability;
+                    current_syscall_error.invalidCapNumber = 1;
+                    status = EXCEPTION_SYSCALL_ERROR;
+                    break;
+                }
+
+                if (cap_frame_cap_get_capFMapType(frameCap) != X86_MappingVSpace) {
+                    userError("X86FrameMapRange: Attempting to remap frame with different mapping type");
+                    current_syscall_error.type = seL4_IllegalOperation;
+                    status = EXCEPTION_SYSCALL_ERROR;
+                    break;
+                }
+
+                if (cap_frame_cap_get_capFMappedAddress(frameCap) != frameVaddr) {
+                    userError("X86FrameMapRange: Attempting to map frame into multiple addresses");
+                    current_syscall_error.type = seL4_InvalidArgument;
+                    current_syscall_error.invalidArgumentNumber = 0;
+                    status = EXCEPTION_SYSCALL_ERROR;
+                    break;
+                }
+            }
+
+            frameCap = cap_frame_cap_set_capFMappedASID(frameCap, asid);
+            frameCap = cap_frame_cap_set_capFMappedAddress(frameCap, frameVaddr);
+            frameCap = cap_frame_cap_set_capFMapType(frameCap, X86_MappingVSpace);
+
+            if (frameSize == X86_SmallPage) {
+                create_mapping_pte_return_t map_ret;
+
+                map_ret = createSafeMappingEntries_PTE(paddr, frameVaddr, vmRights, vmAttr, vspace);
+                if (map_ret.status != EXCEPTION_NONE) {
+                    status = map_ret.status;
+                    break;
+                }
+
+                setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+                frameSlot->cap = frameCap;
+                *map_ret.ptSlot = map_ret.pte;
+            } else {
+                create_mapping_pde_return_t map_ret;
+
+                map_ret = createSafeMappingEntries_PDE(paddr, frameVaddr, vmRights, vmAttr, vspace);
+                if (map_ret.status != EXCEPTION_NONE) {
+                    status = map_ret.status;
+                    break;
+                }
+
+                setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+                frameSlot->cap = frameCap;
+                *map_ret.pdSlot = map_ret.pde;
+            }
+            flush = true;
+        } else {
+            setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+            if (cap_frame_cap_get_capFMappedASID(frameCap) != asidInvalid) {
+                if (cap_frame_cap_get_capFMapType(frameCap) == X86_MappingVSpace) {
+                    unmapRangeFrame(&unmapFlush, frameCap, frameSlot);
+                } else {
+                    performX86FrameInvocationUnmap(frameCap, frameSlot);
+                }
+            }
+        }
+
+        if (i + 1 < count) {
+            status = preemptionPoint();
+            if (status != EXCEPTION_NONE) {
+                advanceFrameRangeArgs(isMap, cptr, vaddr, count, i + 1, frameSize, buffer);
+                break;
+            }
+        }
+    }
+
+    /* one paging structure cache invalidation for the whole range */
+    if (flush) {
+        invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
+                                         SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+    }
+    flushFrameRange(&unmapFlush);
+
+    if (status == EXCEPTION_SYSCALL_ERROR && i > 0) {
+        /* the earlier frames are done, so report the error instead of
+         * restarting the invocation */
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Running);
+    }
+
+    return status;
+}
+#endif /* CONFIG_FRAME_RANGE_INVOCATIONS */
+
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+exception_t Arch_decodeUntypedRetypeMap(object_t newType, word_t count,
+                                        cap_t vspaceCap, vptr_t vaddr)
+{
+    findVSpaceForASID_ret_t find_ret;
+    vspace_root_t  *vspace;
+    vm_page_size_t  frameSize;
+    word_t          i;
+
+    switch (newType) {
+    case seL4_X86_4K:
+        frameSize = X86_SmallPage;
+        break;
+
+    case seL4_X86_LargePageObject:
+        frameSize = X86_LargePage;
+        break;
+
+    default:
+        userError("Untyped RetypeMap: Only small and large pages can be retyped and mapped.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (!isValidNativeRoot(vspaceCap)) {
+        userError("Untyped RetypeMap: Attempting to map frames into invalid page directory cap.");
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 2;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    vspace = (vspace_root_t *)pptr_of_cap(vspaceCap);
+
+    find_ret = findVSpaceForASID(cap_get_capMappedASID(vspaceCap));
+    if (find_ret.status != EXCEPTION_NONE) {
+        current_syscall_error.type = seL4_FailedLookup;
+        current_syscall_error.failedLookupWasSource = false;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (find_ret.vspace_root != vspace) {
+        current_syscall_error.type = seL4_InvalidCapability;
+        current_syscall_error.invalidCapNumber = 2;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (!checkVPAlignment(frameSize, vaddr)) {
+        current_syscall_error.type = seL4_AlignmentError;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* written to avoid overflow in vaddr + count * frame size */
+    if (vaddr > USER_TOP || count > ((USER_TOP - vaddr + 1) >> pageBitsForSize(frameSize))) {
+        userError("Untyped RetypeMap: Mapping address too high.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 6;
+
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    /* Only the checks of creating the mapping entries are needed here, the
+     * entries are created again for the real frames after the retype. */
+    for (i = 0; i < count; i++) {
+        word_t frameVaddr = vaddr + (i << pageBitsForSize(frameSize));
+        exception_t status;
+
+        if (frameSize == X86_SmallPage) {
+            status = createSafeMappingEntries_PTE(0, frameVaddr, VMReadWrite,
+                                                  vmAttributesFromWord(0), vspace).status;
+        } else {
+            status = createSafeMappingEntries_PDE(0, frameVaddr, VMReadWrite,
+                                                  vmAttributesFromWord(0), vspace).status;
+        }
+        if (status != EXCEPTION_NONE) {
+            return status;
+        }
+    }
+
+    return EXCEPTION_NONE;
+}
+
+void Arch_performUntypedRetypeMap(cte_t *slots, word_t count, cap_t vspaceCap,
+                                  vptr_t vaddr, word_t rightsMask, word_t attr)
+{
+    vspace_root_t  *vspace = (vspace_root_t *)pptr_of_cap(vspaceCap);
+    asid_t          asid = cap_get_capMappedASID(vspaceCap);
+    vm_attributes_t vmAttr = vmAttributesFromWord(attr);
+    word_t          i;
+
+    for (i = 0; i < count; i++) {
+        cap_t frameCap = slots[i].cap;
+        vm_page_size_t frameSize = cap_frame_cap_get_capFSize(frameCap);
+        word_t frameVaddr = vaddr + (i << pageBitsForSize(frameSize));
+        paddr_t paddr = pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(frameCap));
+        vm_rights_t vmRights = maskVMRights(cap_frame_cap_get_capFVMRights(frameCap),
+                                            rightsFromWord(rightsMask));
+
+        frameCap = cap_frame_cap_set_capFMappedASID(frameCap, asid);
+        frameCap = cap_frame_cap_set_capFMappedAddress(frameCap, frameVaddr);
+        frameCap = cap_frame_cap_set_capFMapType(frameCap, X86_MappingVSpace);
+
+        if (frameSize == X86_SmallPage) {
+            create_mapping_pte_return_t map_ret;
+
+            map_ret = createSafeMappingEntries_PTE(paddr, frameVaddr, vmRights, vmAttr, vspace);
+            assert(map_ret.status == EXCEPTION_NONE);
+            slots[i].cap = frameCap;
+            *map_ret.ptSlot = map_ret.pte;
+        } else {
+            create_mapping_pde_return_t map_ret;
+
+            map_ret = createSafeMappingEntries_PDE(paddr, frameVaddr, vmRights, vmAttr, vspace);
+            assert(map_ret.status == EXCEPTION_NONE);
+            slots[i].cap = frameCap;
+            *map_ret.pdSlot = map_ret.pde;
+        }
+    }
+
+    /* one paging structure cache invalidation for the whole range */
+    invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
+                                     SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+}
+#endif /* CONFIG_UNTYPED_RETYPE_MAP */
+
 static exception_t performX86PageTableInvocationUnmap(cap_t cap, cte_t *ctSlot)
 {
 
@@ -1259,6 +1752,11 @@ exception_t decodeX86MMUInvocation(
     switch (cap_get_capType(cap)) {
 
     case cap_frame_cap:
+#ifdef CONFIG_FRAME_RANGE_INVOCATIONS
+        if (invLabel == X86PageMapRange || invLabel == X86PageUnmapRange) {
+            return decodeX86FrameRangeInvocation(invLabel, length, cptr, cte, cap, buffer);
+        }
+#endif
         return decodeX86FrameInvocation(invLabel, length, cte, cap, call, buffer);
 
     case cap_page_table_cap:
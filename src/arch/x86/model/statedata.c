@@ -31,6 +31,11 @@ UP_STATE_DEFINE(word_t, x86KSCurrentGSBase);
 
 UP_STATE_DEFINE(word_t, x86KSGPExceptReturnTo);
 
+#ifdef CONFIG_TICKLESS
+UP_STATE_DEFINE(uint32_t, x86KStimerCount);
+UP_STATE_DEFINE(uint64_t, x86KStimerOffset);
+#endif
+
 /* ==== read-only kernel state (only written during bootstrapping) ==== */
 
 /* Defines a translation of cpu ids from an index of our actual CPUs */
@@ -73,3 +78,7 @@ word_t x86KSAllocatedIOPorts[NUM_IO_PORTS / CONFIG_WORD_SIZE];
 uint32_t x86KStscMhz;
 uint32_t x86KSapicRatio;
 #endif
+#ifdef CONFIG_TICKLESS
+/* APIC timer cycles per timer tick */
+uint32_t x86KSapicTickCycles;
+#endif
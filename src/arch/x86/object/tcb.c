@@ -10,6 +10,13 @@
 #include <object/structures.h>
 #include <arch/object/tcb.h>
 #include <arch/machine.h>
+#ifdef CONFIG_MESSAGE_WINDOW
+#include <kernel/cspace.h>
+#include <object/cnode.h>
+#include <arch/kernel/vspace.h>
+#include <arch/kernel/tlb.h>
+#include <arch/kernel/tlb_bitmap.h>
+#endif
 
 word_t CONST Arch_decodeTransfer(word_t flags)
 {
@@ -80,3 +87,250 @@ exception_t decodeSetEPTRoot(cap_t cap)
     return performSetEPTRoot(TCB_PTR(cap_thread_cap_get_capTCBPtr(cap)), dc_ret.cap, rootSlot);
 }
 #endif
+
+#ifdef CONFIG_MESSAGE_WINDOW
+/* Looks up the PT slot for a message window address in a thread's VSpace. The
+ * status is EXCEPTION_SYSCALL_ERROR if the thread has no valid VSpace and
+ * EXCEPTION_LOOKUP_FAULT, with current_lookup_fault set, if there is no page
+ * table at the address. */
+static lookupPTSlot_ret_t lookupMessageWindowSlot(tcb_t *tcb, vptr_t vaddr, vspace_root_t **vspace, asid_t *asid)
+{
+    cap_t vspaceCap;
+    findVSpaceForASID_ret_t find_ret;
+    lookupPTSlot_ret_t lu_ret;
+
+    vspaceCap = TCB_PTR_CTE_PTR(tcb, tcbVTable)->cap;
+    if (!isValidNativeRoot(vspaceCap)) {
+        lu_ret.status = EXCEPTION_SYSCALL_ERROR;
+        lu_ret.ptSlot = NULL;
+        return lu_ret;
+    }
+
+    *vspace = (vspace_root_t *)pptr_of_cap(vspaceCap);
+    *asid = cap_get_capMappedASID(vspaceCap);
+
+    find_ret = findVSpaceForASID(*asid);
+    if (find_ret.status != EXCEPTION_NONE) {
+        lu_ret.status = EXCEPTION_LOOKUP_FAULT;
+        lu_ret.ptSlot = NULL;
+        return lu_ret;
+    }
+    if (find_ret.vspace_root != *vspace) {
+        lu_ret.status = EXCEPTION_SYSCALL_ERROR;
+        lu_ret.ptSlot = NULL;
+        return lu_ret;
+    }
+
+    return lookupPTSlot(*vspace, vaddr);
+}
+
+/* Whether a window slot can take a new mapping: it must be empty, unless
+ * it holds the mapping of the frame that is being moved. */
+static bool_t isMessageWindowSlotFree(pte_t *ptSlot, asid_t asid, vptr_t vaddr, cap_t frameCap)
+{
+    return !pte_ptr_get_present(ptSlot) ||
+           (cap_get_capType(frameCap) == cap_frame_cap &&
+            cap_frame_cap_get_capFMappedASID(frameCap) == asid &&
+            cap_frame_cap_get_capFMappedAddress(frameCap) == vaddr);
+}
+
+static cap_t mapMessageWindow(cap_t cap, pte_t *ptSlot, vspace_root_t *vspace, asid_t asid, vptr_t vaddr)
+{
+    *ptSlot = makeUserPTE(pptr_to_paddr((void *)cap_frame_cap_get_capFBasePtr(cap)),
+                          vmAttributesFromWord(0), cap_frame_cap_get_capFVMRights(cap));
+    invalidatePageStructureCacheASID(pptr_to_paddr(vspace), asid,
+                                     SMP_TERNARY(tlb_bitmap_get(vspace), 0));
+
+    cap = cap_frame_cap_set_capFMappedASID(cap, asid);
+    cap = cap_frame_cap_set_capFMappedAddress(cap, vaddr);
+    return cap_frame_cap_set_capFMapType(cap, X86_MappingVSpace);
+}
+
+static exception_t performSetMessageWindow(tcb_t *tcb, vptr_t vaddr, cte_t *frameSlot,
+                                           pte_t *ptSlot, vspace_root_t *vspace, asid_t asid)
+{
+    cte_t *windowSlot;
+
+    windowSlot = TCB_PTR_CTE_PTR(tcb, tcbArchMsgWindow);
+    cteDeleteOne(windowSlot);
+    tcb->tcbArch.tcbMsgWindowAddr = vaddr;
+
+    if (ptSlot != NULL) {
+        cteMove(mapMessageWindow(frameSlot->cap, ptSlot, vspace, asid, vaddr), frameSlot, windowSlot);
+    }
+
+    return EXCEPTION_NONE;
+}
+
+exception_t decodeSetMessageWindow(cap_t cap, word_t length, word_t *buffer)
+{
+    tcb_t *tcb;
+    vptr_t vaddr;
+    cte_t *frameSlot;
+    cap_t frameCap;
+    lookupPTSlot_ret_t lu_ret;
+    pte_t *ptSlot = NULL;
+    vspace_root_t *vspace = NULL;
+    asid_t asid = asidInvalid;
+
+    if (length < 1 || current_extra_caps.excaprefs[0] == NULL) {
+        userError("TCB SetMessageWindow: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+    vaddr = getSyscallArg(0, buffer);
+    frameSlot = current_extra_caps.excaprefs[0];
+    frameCap = frameSlot->cap;
+
+    if (!IS_ALIGNED(vaddr, seL4_PageBits) || vaddr > USER_TOP - BIT(seL4_PageBits)) {
+        userError("TCB SetMessageWindow: Invalid window address.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (cap_get_capType(frameCap) != cap_null_cap) {
+        if (cap_get_capType(frameCap) != cap_frame_cap ||
+            cap_frame_cap_get_capFSize(frameCap) != X86_SmallPage ||
+            cap_frame_cap_get_capFIsDevice(frameCap) ||
+            cap_frame_cap_get_capFVMRights(frameCap) == VMKernelOnly ||
+            cap_frame_cap_get_capFMappedASID(frameCap) != asidInvalid) {
+            userError("TCB SetMessageWindow: The frame must be an unmapped 4K frame of normal memory.");
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 1;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        if (vaddr == 0) {
+            userError("TCB SetMessageWindow: A frame needs a window address.");
+            current_syscall_error.type = seL4_InvalidArgument;
+            current_syscall_error.invalidArgumentNumber = 0;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        lu_ret = lookupMessageWindowSlot(tcb, vaddr, &vspace, &asid);
+        if (lu_ret.status == EXCEPTION_SYSCALL_ERROR) {
+            userError("TCB SetMessageWindow: The thread has no valid VSpace.");
+            current_syscall_error.type = seL4_InvalidCapability;
+            current_syscall_error.invalidCapNumber = 0;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        if (lu_ret.status != EXCEPTION_NONE) {
+            userError("TCB SetMessageWindow: No page table at the window address.");
+            current_syscall_error.type = seL4_FailedLookup;
+            current_syscall_error.failedLookupWasSource = false;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        ptSlot = lu_ret.ptSlot;
+
+        /* The window's current frame is unmapped when it is replaced */
+        if (!isMessageWindowSlotFree(ptSlot, asid, vaddr, TCB_PTR_CTE_PTR(tcb, tcbArchMsgWindow)->cap)) {
+            userError("TCB SetMessageWindow: The window address is already mapped.");
+            current_syscall_error.type = seL4_DeleteFirst;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return performSetMessageWindow(tcb, vaddr, frameSlot, ptSlot, vspace, asid);
+}
+
+static exception_t performTakeMessageWindow(tcb_t *tcb, cte_t *destSlot)
+{
+    cte_t *windowSlot;
+    cap_t cap;
+
+    windowSlot = TCB_PTR_CTE_PTR(tcb, tcbArchMsgWindow);
+    cap = windowSlot->cap;
+
+    if (cap_frame_cap_get_capFMappedASID(cap) != asidInvalid) {
+        unmapPage(X86_SmallPage, cap_frame_cap_get_capFMappedASID(cap),
+                  cap_frame_cap_get_capFMappedAddress(cap), (void *)cap_frame_cap_get_capFBasePtr(cap));
+    }
+
+    cap = cap_frame_cap_set_capFMappedAddress(cap, 0);
+    cap = cap_frame_cap_set_capFMappedASID(cap, asidInvalid);
+    cap = cap_frame_cap_set_capFMapType(cap, X86_MappingNone);
+    cteMove(cap, windowSlot, destSlot);
+
+    return EXCEPTION_NONE;
+}
+
+exception_t decodeTakeMessageWindow(cap_t cap, word_t length, word_t *buffer)
+{
+    tcb_t *tcb;
+    word_t index, depth;
+    cap_t root;
+    lookupSlot_ret_t lu_ret;
+    exception_t status;
+
+    if (length < 2 || current_extra_caps.excaprefs[0] == NULL) {
+        userError("TCB TakeMessageWindow: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    tcb = TCB_PTR(cap_thread_cap_get_capTCBPtr(cap));
+    index = getSyscallArg(0, buffer);
+    depth = getSyscallArg(1, buffer);
+    root = current_extra_caps.excaprefs[0]->cap;
+
+    if (cap_get_capType(TCB_PTR_CTE_PTR(tcb, tcbArchMsgWindow)->cap) == cap_null_cap) {
+        userError("TCB TakeMessageWindow: The message window holds no frame.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    lu_ret = lookupTargetSlot(root, index, depth);
+    if (lu_ret.status != EXCEPTION_NONE) {
+        userError("TCB TakeMessageWindow: Failed to lookup destination slot.");
+        return lu_ret.status;
+    }
+
+    status = ensureEmptySlot(lu_ret.slot);
+    if (status != EXCEPTION_NONE) {
+        userError("TCB TakeMessageWindow: Destination slot not empty.");
+        return status;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    return performTakeMessageWindow(tcb, lu_ret.slot);
+}
+
+void Arch_transferMessageWindow(tcb_t *sender, tcb_t *receiver)
+{
+    cte_t *srcSlot, *destSlot;
+    cap_t cap;
+    vptr_t vaddr;
+    lookupPTSlot_ret_t lu_ret;
+    vspace_root_t *vspace;
+    asid_t asid;
+
+    srcSlot = TCB_PTR_CTE_PTR(sender, tcbArchMsgWindow);
+    destSlot = TCB_PTR_CTE_PTR(receiver, tcbArchMsgWindow);
+    cap = srcSlot->cap;
+    vaddr = receiver->tcbArch.tcbMsgWindowAddr;
+
+    if (likely(cap_get_capType(cap) == cap_null_cap)) {
+        return;
+    }
+
+    /* The frame stays with the sender if the receiver cannot take it */
+    if (vaddr == 0 || cap_get_capType(destSlot->cap) != cap_null_cap) {
+        return;
+    }
+    lu_ret = lookupMessageWindowSlot(receiver, vaddr, &vspace, &asid);
+    if (lu_ret.status != EXCEPTION_NONE || !isMessageWindowSlotFree(lu_ret.ptSlot, asid, vaddr, cap)) {
+        return;
+    }
+
+    if (cap_frame_cap_get_capFMappedASID(cap) != asidInvalid) {
+        unmapPage(X86_SmallPage, cap_frame_cap_get_capFMappedASID(cap),
+                  cap_frame_cap_get_capFMappedAddress(cap), (void *)cap_frame_cap_get_capFBasePtr(cap));
+    }
+
+    cteMove(mapMessageWindow(cap, lu_ret.ptSlot, vspace, asid, vaddr), srcSlot, destSlot);
+}
+#endif
@@ -12,6 +12,7 @@
 #include <mode/machine.h>
 #include <benchmark/benchmark.h>
 #include <benchmark/benchmark_utilisation.h>
+#include <benchmark/benchmark_track.h>
 
 
 exception_t handle_SysBenchmarkFlushCaches(void)
@@ -40,8 +41,15 @@ exception_t handle_SysBenchmarkResetLog(void)
     }
 
     ksLogIndex = 0;
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+    tracepoint_rings_reset();
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
 #endif /* CONFIG_KERNEL_LOG_BUFFER */
 
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+    benchmark_entry_histograms_reset();
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
+
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
     NODE_STATE(benchmark_log_utilisation_enabled) = true;
     benchmark_track_reset_utilisation(NODE_STATE(ksIdleThread));
@@ -61,7 +69,18 @@ exception_t handle_SysBenchmarkResetLog(void)
 exception_t handle_SysBenchmarkFinalizeLog(void)
 {
 #ifdef CONFIG_KERNEL_LOG_BUFFER
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+    /* Each core only writes its own ring, so record every core's head in its
+     * ring and report the total number of entries written to all of them. */
+    ksLogIndexFinalized = 0;
+    for (word_t core = 0; core < CONFIG_MAX_NUM_NODES; core++) {
+        word_t head = NODE_STATE_ON_CORE(benchmark_tracepoint_head, core);
+        tracepoint_ring(core)->finalized = head;
+        ksLogIndexFinalized += head;
+    }
+#else
     ksLogIndexFinalized = ksLogIndex;
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
     setRegister(NODE_STATE(ksCurThread), capRegister, ksLogIndexFinalized);
 #endif /* CONFIG_KERNEL_LOG_BUFFER */
 
@@ -81,11 +100,45 @@ exception_t handle_SysBenchmarkSetLogBuffer(void)
         return EXCEPTION_SYSCALL_ERROR;
     }
 
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+    tracepoint_rings_reset();
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
+
     setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
     return EXCEPTION_NONE;
 }
 #endif /* CONFIG_KERNEL_LOG_BUFFER */
 
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+compile_assert(entry_histogram_fits_ipc_buffer,
+               sizeof(benchmark_entry_histogram_t) <= seL4_MsgMaxLength * sizeof(word_t))
+
+exception_t handle_SysBenchmarkGetEntryHistogram(void)
+{
+    word_t core = getRegister(NODE_STATE(ksCurThread), capRegister);
+    word_t index = getRegister(NODE_STATE(ksCurThread), msgInfoRegister);
+    seL4_IPCBuffer *buffer = (seL4_IPCBuffer *)lookupIPCBuffer(true, NODE_STATE(ksCurThread));
+
+    if (core >= ksNumCPUs || index > seL4_BenchmarkEntryHistograms) {
+        userError("SysBenchmarkGetEntryHistogram: core %lu or histogram %lu out of range", core, index);
+        setRegister(NODE_STATE(ksCurThread), capRegister, seL4_InvalidArgument);
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (buffer == NULL) {
+        userError("SysBenchmarkGetEntryHistogram: the caller has no IPC buffer");
+        setRegister(NODE_STATE(ksCurThread), capRegister, seL4_IllegalOperation);
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    memcpy(&buffer->msg[0], &NODE_STATE_ON_CORE(benchmark_entry_histograms, core)[index],
+           sizeof(benchmark_entry_histogram_t));
+
+    setRegister(NODE_STATE(ksCurThread), capRegister, seL4_NoError);
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
+
 #ifdef CONFIG_BENCHMARK_TRACK_UTILISATION
 
 exception_t handle_SysBenchmarkGetThreadUtilisation(void)
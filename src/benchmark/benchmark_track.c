@@ -11,6 +11,78 @@
 #ifdef CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES
 
 timestamp_t ksEnter;
+
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+
+#ifdef CONFIG_SMP_NODE_LOCKS
+#error "Kernel entry histograms are keyed from ksKernelEntry, which node locks do not protect"
+#endif
+
+/* Number of histograms tried for a key before the entry is counted in the
+ * overflow histogram. This bounds the cost of tracking an entry. */
+#define ENTRY_HISTOGRAM_PROBES 8
+
+static inline bool_t entry_key_equals(kernel_entry_t a, kernel_entry_t b)
+{
+    return a.path == b.path && a.core == b.core && a.word == b.word;
+}
+
+static inline word_t entry_histogram_index(kernel_entry_t entry)
+{
+    uint32_t key = (uint32_t)entry.path | ((uint32_t)entry.core << 3) | ((uint32_t)entry.word << 6);
+
+    /* multiplicative hash, the top bits of the product select the histogram */
+    return (uint32_t)(key * 2654435761u) >> (32 - CONFIG_BENCHMARK_ENTRY_HISTOGRAM_BITS);
+}
+
+static inline word_t entry_histogram_bucket(timestamp_t duration)
+{
+    word_t bucket;
+
+    if (duration == 0) {
+        return 0;
+    }
+    bucket = 63 - clzll(duration);
+
+    return MIN(bucket, seL4_BenchmarkEntryHistogramBuckets - 1);
+}
+
+void benchmark_track_exit(void)
+{
+    timestamp_t duration = timestamp() - ksEnter;
+    benchmark_entry_histogram_t *histograms = NODE_STATE(benchmark_entry_histograms);
+    benchmark_entry_histogram_t *histogram = &histograms[seL4_BenchmarkEntryHistograms];
+    word_t index = entry_histogram_index(ksKernelEntry);
+
+    for (word_t i = 0; i < ENTRY_HISTOGRAM_PROBES; i++) {
+        benchmark_entry_histogram_t *candidate =
+            &histograms[(index + i) & MASK(CONFIG_BENCHMARK_ENTRY_HISTOGRAM_BITS)];
+
+        if (!candidate->in_use) {
+            candidate->in_use = true;
+            candidate->entry = ksKernelEntry;
+            histogram = candidate;
+            break;
+        }
+        if (entry_key_equals(candidate->entry, ksKernelEntry)) {
+            histogram = candidate;
+            break;
+        }
+    }
+
+    histogram->count[entry_histogram_bucket(duration)]++;
+}
+
+void benchmark_entry_histograms_reset(void)
+{
+    for (word_t core = 0; core < CONFIG_MAX_NUM_NODES; core++) {
+        memzero(NODE_STATE_ON_CORE(benchmark_entry_histograms, core),
+                sizeof(NODE_STATE(benchmark_entry_histograms)));
+    }
+}
+
+#else
+
 seL4_Word ksLogIndex;
 seL4_Word ksLogIndexFinalized;
 
@@ -31,4 +103,5 @@ void benchmark_track_exit(void)
         }
     }
 }
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
 #endif /* CONFIG_BENCHMARK_TRACK_KERNEL_ENTRIES */
@@ -64,6 +64,13 @@ void benchmark_track_utilisation_dump(void)
     buffer[BENCHMARK_TOTAL_NUMBER_SCHEDULES] = NODE_STATE(benchmark_kernel_number_schedules);
     buffer[BENCHMARK_TOTAL_KERNEL_UTILISATION] = NODE_STATE(benchmark_kernel_time);
     buffer[BENCHMARK_TOTAL_NUMBER_KERNEL_ENTRIES] = NODE_STATE(benchmark_kernel_number_entries);
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    buffer[BENCHMARK_TOTAL_SHOOTDOWN_IPIS_SENT] = MODE_NODE_STATE(x64KSShootdowns).ipisSent;
+    buffer[BENCHMARK_TOTAL_SHOOTDOWN_IPIS_AVOIDED] = MODE_NODE_STATE(x64KSShootdowns).ipisAvoided;
+#endif
+#ifdef CONFIG_IRQ_RATE_LIMIT
+    buffer[BENCHMARK_TOTAL_SUPPRESSED_IRQS] = NODE_STATE(ksIRQSuppressed);
+#endif
 
 }
 
@@ -11,6 +11,9 @@
 #include <benchmark/benchmark_track.h>
 #endif
 #include <benchmark/benchmark_utilisation.h>
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+#include <object/interrupt.h>
+#endif
 
 #ifdef CONFIG_ARCH_ARM
 static inline
@@ -35,12 +38,29 @@ void NORETURN fastpath_call(word_t cptr, word_t msgInfo)
     length = seL4_MessageInfo_get_length(info);
     fault_type = seL4_Fault_get_seL4_FaultType(NODE_STATE(ksCurThread)->tcbFault);
 
+#if defined(CONFIG_FASTPATH_EXTRA_CAP) || defined(CONFIG_FASTPATH_LONG_MESSAGES)
+    /* Check the extra caps and the length are ok for the enabled fastpath
+     * extensions and there's no saved fault. */
+    if (unlikely(fastpath_mi_check_ext(msgInfo) ||
+                 fault_type != seL4_Fault_NullFault)) {
+        slowpath(SysCall);
+    }
+#else
     /* Check there's no extra caps, the length is ok and there's no
      * saved fault. */
     if (unlikely(fastpath_mi_check(msgInfo) ||
                  fault_type != seL4_Fault_NullFault)) {
         slowpath(SysCall);
     }
+#endif
+
+#ifdef CONFIG_MESSAGE_WINDOW
+    /* Moving the frame in the message window is left to the slowpath */
+    if (unlikely(cap_get_capType(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbArchMsgWindow)->cap) !=
+                 cap_null_cap)) {
+        slowpath(SysCall);
+    }
+#endif
 
     /* Lookup the cap */
     ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap, cptr);
@@ -54,6 +74,13 @@ void NORETURN fastpath_call(word_t cptr, word_t msgInfo)
     /* Get the endpoint address */
     ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
 
+#ifdef CONFIG_SMP_NODE_LOCKS
+    /* Fastpaths on other cores may be using the same endpoint */
+    if (unlikely(!node_lock_try_acquire_ep(getCurrentCPUIndex(), ep_ptr))) {
+        slowpath(SysCall);
+    }
+#endif
+
     /* Get the destination thread, which is only going to be valid
      * if the endpoint is valid. */
     dest = TCB_PTR(endpoint_ptr_get_epQueue_head(ep_ptr));
@@ -121,13 +148,22 @@ void NORETURN fastpath_call(word_t cptr, word_t msgInfo)
 #endif
 
     /* let gcc optimise this out for 1 domain */
-    dom = maxDom ? ksCurDomain : 0;
+    dom = maxDom ? DOM_STATE(ksCurDomain) : 0;
     /* ensure only the idle thread or lower prio threads are present in the scheduler */
     if (unlikely(dest->tcbPriority < NODE_STATE(ksCurThread->tcbPriority) &&
                  !isHighestPrio(dom, dest->tcbPriority))) {
         slowpath(SysCall);
     }
 
+#ifdef CONFIG_TICKLESS
+    /* While the timer is stopped, let schedule() arm it for the timeslice of
+     * a destination that has ready threads of the same priority */
+    if (unlikely(ARCH_NODE_STATE(x86KStimerCount) == 0 &&
+                 READY_QUEUE(dom, dest->tcbPriority).head != NULL)) {
+        slowpath(SysCall);
+    }
+#endif
+
     /* Ensure that the endpoint has has grant or grant-reply rights so that we can
      * create the reply cap */
     if (unlikely(!cap_endpoint_cap_get_capCanGrant(ep_cap) &&
@@ -142,7 +178,7 @@ void NORETURN fastpath_call(word_t cptr, word_t msgInfo)
 #endif
 
     /* Ensure the original caller is in the current domain and can be scheduled directly. */
-    if (unlikely(dest->tcbDomain != ksCurDomain && 0 < maxDom)) {
+    if (unlikely(dest->tcbDomain != DOM_STATE(ksCurDomain) && 0 < maxDom)) {
         slowpath(SysCall);
     }
 
@@ -164,6 +200,35 @@ void NORETURN fastpath_call(word_t cptr, word_t msgInfo)
     }
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+    cte_t *extraCapSrcSlot = NULL, *extraCapDestSlot = NULL;
+    word_t *recvBuffer = NULL;
+    if (unlikely(seL4_MessageInfo_get_extraCaps(info) != 0)) {
+#ifdef CONFIG_SMP_NODE_LOCKS
+        /* Changing the MDB needs the big kernel lock */
+        if (unlikely(node_lock_is_held(getCurrentCPUIndex()))) {
+            slowpath(SysCall);
+        }
+#endif
+        /* The slowpath drops the cap if the endpoint has no grant right */
+        if (unlikely(!cap_endpoint_cap_get_capCanGrant(ep_cap) ||
+                     !fastpath_extra_cap_check(NODE_STATE(ksCurThread), dest, ep_ptr,
+                                               &extraCapSrcSlot, &extraCapDestSlot,
+                                               &recvBuffer))) {
+            slowpath(SysCall);
+        }
+    }
+#endif
+
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    word_t *longSendBuffer = NULL, *longRecvBuffer = NULL;
+    if (unlikely(length > n_msgRegisters &&
+                 !fastpath_long_msg_check(NODE_STATE(ksCurThread), dest,
+                                          &longSendBuffer, &longRecvBuffer))) {
+        slowpath(SysCall);
+    }
+#endif
+
     /*
      * --- POINT OF NO RETURN ---
      *
@@ -220,14 +285,33 @@ void NORETURN fastpath_call(word_t cptr, word_t msgInfo)
         &replySlot->cteMDBNode, CTE_REF(callerSlot), 1, 1);
 #endif
 
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    fastpath_copy_mrs(MIN(length, n_msgRegisters), NODE_STATE(ksCurThread), dest);
+    if (unlikely(length > n_msgRegisters)) {
+        fastpath_copy_long_msg(length, longSendBuffer, longRecvBuffer);
+    }
+#else
     fastpath_copy_mrs(length, NODE_STATE(ksCurThread), dest);
+#endif
+
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+    if (unlikely(extraCapSrcSlot != NULL)) {
+        info = fastpath_extra_cap_transfer(info, extraCapSrcSlot, extraCapDestSlot, recvBuffer);
+    } else {
+        info = seL4_MessageInfo_set_capsUnwrapped(info, 0);
+    }
+#endif
 
     /* Dest thread is set Running, but not queued. */
     thread_state_ptr_set_tsType_np(&dest->tcbState,
                                    ThreadState_Running);
     switchToThread_fp(dest, cap_pd, stored_hw_asid);
 
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+    msgInfo = wordFromMessageInfo(info);
+#else
     msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
+#endif
 
     fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
 }
@@ -261,12 +345,29 @@ void NORETURN fastpath_reply_recv(word_t cptr, word_t msgInfo)
     length = seL4_MessageInfo_get_length(info);
     fault_type = seL4_Fault_get_seL4_FaultType(NODE_STATE(ksCurThread)->tcbFault);
 
+#if defined(CONFIG_FASTPATH_EXTRA_CAP) || defined(CONFIG_FASTPATH_LONG_MESSAGES)
+    /* Check the extra caps and the length are ok for the enabled fastpath
+     * extensions and there's no saved fault. */
+    if (unlikely(fastpath_mi_check_ext(msgInfo) ||
+                 fault_type != seL4_Fault_NullFault)) {
+        slowpath(SysReplyRecv);
+    }
+#else
     /* Check there's no extra caps, the length is ok and there's no
      * saved fault. */
     if (unlikely(fastpath_mi_check(msgInfo) ||
                  fault_type != seL4_Fault_NullFault)) {
         slowpath(SysReplyRecv);
     }
+#endif
+
+#ifdef CONFIG_MESSAGE_WINDOW
+    /* Moving the frame in the message window is left to the slowpath */
+    if (unlikely(cap_get_capType(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbArchMsgWindow)->cap) !=
+                 cap_null_cap)) {
+        slowpath(SysReplyRecv);
+    }
+#endif
 
     /* Lookup the cap */
     ep_cap = lookup_fp(TCB_PTR_CTE_PTR(NODE_STATE(ksCurThread), tcbCTable)->cap,
@@ -294,9 +395,23 @@ void NORETURN fastpath_reply_recv(word_t cptr, word_t msgInfo)
         slowpath(SysReplyRecv);
     }
 
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    /* Let the slowpath ack the IRQs that signalled the bound notification */
+    if (unlikely(NODE_STATE(ksCurThread)->tcbBoundNotification && gic_num_pending_deactivate)) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
     /* Get the endpoint address */
     ep_ptr = EP_PTR(cap_endpoint_cap_get_capEPPtr(ep_cap));
 
+#ifdef CONFIG_SMP_NODE_LOCKS
+    /* Fastpaths on other cores may be using the same endpoint */
+    if (unlikely(!node_lock_try_acquire_ep(getCurrentCPUIndex(), ep_ptr))) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
     /* Check that there's not a thread waiting to send */
     if (unlikely(endpoint_ptr_get_state(ep_ptr) == EPState_Send)) {
         slowpath(SysReplyRecv);
@@ -398,11 +513,20 @@ void NORETURN fastpath_reply_recv(word_t cptr, word_t msgInfo)
 #endif
 
     /* Ensure the original caller can be scheduled directly. */
-    dom = maxDom ? ksCurDomain : 0;
+    dom = maxDom ? DOM_STATE(ksCurDomain) : 0;
     if (unlikely(!isHighestPrio(dom, caller->tcbPriority))) {
         slowpath(SysReplyRecv);
     }
 
+#ifdef CONFIG_TICKLESS
+    /* While the timer is stopped, let schedule() arm it for the timeslice of
+     * a caller that has ready threads of the same priority */
+    if (unlikely(ARCH_NODE_STATE(x86KStimerCount) == 0 &&
+                 READY_QUEUE(dom, caller->tcbPriority).head != NULL)) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
 #ifdef CONFIG_ARCH_AARCH32
     /* Ensure the HWASID is valid. */
     if (unlikely(!pde_pde_invalid_get_stored_asid_valid(stored_hw_asid))) {
@@ -411,7 +535,7 @@ void NORETURN fastpath_reply_recv(word_t cptr, word_t msgInfo)
 #endif
 
     /* Ensure the original caller is in the current domain and can be scheduled directly. */
-    if (unlikely(caller->tcbDomain != ksCurDomain && 0 < maxDom)) {
+    if (unlikely(caller->tcbDomain != DOM_STATE(ksCurDomain) && 0 < maxDom)) {
         slowpath(SysReplyRecv);
     }
 
@@ -428,11 +552,47 @@ void NORETURN fastpath_reply_recv(word_t cptr, word_t msgInfo)
     }
 #endif /* ENABLE_SMP_SUPPORT */
 
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+    cte_t *extraCapSrcSlot = NULL, *extraCapDestSlot = NULL;
+    word_t *recvBuffer = NULL;
+    if (unlikely(seL4_MessageInfo_get_extraCaps(info) != 0)) {
+        /* Replies carry no endpoint, so the cap is never unwrapped. A
+         * caller that faulted takes the slowpath above unless the exception
+         * fastpath is enabled, in which case it receives no message. */
+#ifdef CONFIG_KERNEL_MCS
+        word_t replyCanGrant = cap_reply_cap_get_capReplyCanGrant(reply_cap);
+#else
+        word_t replyCanGrant = cap_reply_cap_get_capReplyCanGrant(callerCap);
+#endif
+#ifdef CONFIG_SMP_NODE_LOCKS
+        /* Changing the MDB needs the big kernel lock */
+        if (unlikely(node_lock_is_held(getCurrentCPUIndex()))) {
+            slowpath(SysReplyRecv);
+        }
+#endif
+        if (unlikely(fault_type != seL4_Fault_NullFault || !replyCanGrant ||
+                     !fastpath_extra_cap_check(NODE_STATE(ksCurThread), caller, NULL,
+                                               &extraCapSrcSlot, &extraCapDestSlot,
+                                               &recvBuffer))) {
+            slowpath(SysReplyRecv);
+        }
+    }
+#endif
+
 #ifdef CONFIG_KERNEL_MCS
     /* not possible to set reply object and not be blocked */
     assert(thread_state_get_replyObject(NODE_STATE(ksCurThread)->tcbState) == 0);
 #endif
 
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+    word_t *longSendBuffer = NULL, *longRecvBuffer = NULL;
+    if (unlikely(length > n_msgRegisters &&
+                 !fastpath_long_msg_check(NODE_STATE(ksCurThread), caller,
+                                          &longSendBuffer, &longRecvBuffer))) {
+        slowpath(SysReplyRecv);
+    }
+#endif
+
     /*
      * --- POINT OF NO RETURN ---
      *
@@ -540,13 +700,32 @@ void NORETURN fastpath_reply_recv(word_t cptr, word_t msgInfo)
         /* Replies don't have a badge. */
         badge = 0;
 
+#ifdef CONFIG_FASTPATH_LONG_MESSAGES
+        fastpath_copy_mrs(MIN(length, n_msgRegisters), NODE_STATE(ksCurThread), caller);
+        if (unlikely(length > n_msgRegisters)) {
+            fastpath_copy_long_msg(length, longSendBuffer, longRecvBuffer);
+        }
+#else
         fastpath_copy_mrs(length, NODE_STATE(ksCurThread), caller);
+#endif
+
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+        if (unlikely(extraCapSrcSlot != NULL)) {
+            info = fastpath_extra_cap_transfer(info, extraCapSrcSlot, extraCapDestSlot, recvBuffer);
+        } else {
+            info = seL4_MessageInfo_set_capsUnwrapped(info, 0);
+        }
+#endif
 
         /* Dest thread is set Running, but not queued. */
         thread_state_ptr_set_tsType_np(&caller->tcbState, ThreadState_Running);
         switchToThread_fp(caller, cap_pd, stored_hw_asid);
 
+#ifdef CONFIG_FASTPATH_EXTRA_CAP
+        msgInfo = wordFromMessageInfo(info);
+#else
         msgInfo = wordFromMessageInfo(seL4_MessageInfo_set_capsUnwrapped(info, 0));
+#endif
 
         fastpath_restore(badge, msgInfo, NODE_STATE(ksCurThread));
 
@@ -671,7 +850,7 @@ void NORETURN fastpath_signal(word_t cptr, word_t msgInfo)
     }
 
     /* Check if signal is cross-core or cross-domain */
-    if (ksCurDomain != dest->tcbDomain SMP_COND_STATEMENT( || sc->scCore != getCurrentCPUIndex())) {
+    if (DOM_STATE(ksCurDomain) != dest->tcbDomain SMP_COND_STATEMENT( || sc->scCore != getCurrentCPUIndex())) {
         crossnode = true;
     }
 
@@ -719,6 +898,93 @@ void NORETURN fastpath_signal(word_t cptr, word_t msgInfo)
 }
 #endif
 
+#ifdef CONFIG_WAIT_FASTPATH
+#ifdef CONFIG_ARCH_ARM
+static inline
+FORCE_INLINE
+#endif
+void NORETURN fastpath_wait(word_t cptr, syscall_t syscall)
+{
+    tcb_t *thread = NODE_STATE(ksCurThread);
+    notification_t *ntfnPtr;
+    tcb_t *boundTCB;
+    bool_t isBlocking;
+    cap_t cap;
+
+#ifdef CONFIG_KERNEL_MCS
+    isBlocking = syscall == SysRecv || syscall == SysWait;
+#else
+    isBlocking = syscall == SysRecv;
+#endif
+
+    /* Check there's no saved fault. Can be removed if the current thread can't
+     * have a fault while invoking the fastpath */
+    if (unlikely(seL4_Fault_get_seL4_FaultType(thread->tcbFault) != seL4_Fault_NullFault)) {
+        slowpath(syscall);
+    }
+
+    /* Lookup the cap */
+    cap = lookup_fp(TCB_PTR_CTE_PTR(thread, tcbCTable)->cap, cptr);
+
+    /* Check it's a notification that we are allowed to receive on. Endpoints
+     * and lookup failures take the slowpath. */
+    if (unlikely(!cap_capType_equals(cap, cap_notification_cap) ||
+                 !cap_notification_cap_get_capNtfnCanReceive(cap))) {
+        slowpath(syscall);
+    }
+
+    ntfnPtr = NTFN_PTR(cap_notification_cap_get_capNtfnPtr(cap));
+
+    /* Only the bound thread may receive on a bound notification */
+    boundTCB = (tcb_t *)notification_ptr_get_ntfnBoundTCB(ntfnPtr);
+    if (unlikely(boundTCB && boundTCB != thread)) {
+        slowpath(syscall);
+    }
+
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    if (unlikely(gic_num_pending_deactivate)) {
+        ackDeferredIRQs(ntfnPtr);
+    }
+#endif
+
+    if (notification_ptr_get_state(ntfnPtr) == NtfnState_Active) {
+#ifdef CONFIG_KERNEL_MCS
+        /* Receiving on a notification with a bound SC may need to donate it */
+        if (unlikely(thread->tcbSchedContext != NODE_STATE(ksCurSC))) {
+            slowpath(syscall);
+        }
+#endif
+        /* Return the pending badge and stay on the current thread */
+        setRegister(thread, badgeRegister, notification_ptr_get_ntfnMsgIdentifier(ntfnPtr));
+        notification_ptr_set_state(ntfnPtr, NtfnState_Idle);
+        restore_user_context();
+        UNREACHABLE();
+    }
+
+    if (!isBlocking) {
+        doNBRecvFailedTransfer(thread);
+        restore_user_context();
+        UNREACHABLE();
+    }
+
+#ifdef CONFIG_KERNEL_MCS
+    /* Blocking charges the consumed time and may return the SC of a passive
+     * thread to the notification, which is left to the slowpath. */
+    slowpath(syscall);
+#else
+    ntfn_queue_append_fp(thread, ntfnPtr);
+
+    /* The current thread is no longer runnable, so the scheduler picks the
+     * highest priority runnable thread straight from the ready queue bitmaps. */
+    scheduleTCB(thread);
+    schedule();
+    activateThread();
+
+    restore_user_context();
+#endif
+}
+#endif
+
 #ifdef CONFIG_EXCEPTION_FASTPATH
 static inline
 FORCE_INLINE
@@ -799,7 +1065,7 @@ void NORETURN fastpath_vm_fault(vm_fault_type_t type)
 #endif
 
     /* let gcc optimise this out for 1 domain */
-    dom = maxDom ? ksCurDomain : 0;
+    dom = maxDom ? DOM_STATE(ksCurDomain) : 0;
     /* ensure only the idle thread or lower prio threads are present in the scheduler */
     if (unlikely(dest->tcbPriority < NODE_STATE(ksCurThread->tcbPriority) &&
                  !isHighestPrio(dom, dest->tcbPriority))) {
@@ -808,7 +1074,7 @@ void NORETURN fastpath_vm_fault(vm_fault_type_t type)
     }
 
     /* Ensure the original caller is in the current domain and can be scheduled directly. */
-    if (unlikely(dest->tcbDomain != ksCurDomain && 0 < maxDom)) {
+    if (unlikely(dest->tcbDomain != DOM_STATE(ksCurDomain) && 0 < maxDom)) {
         vm_fault_slowpath(type);
     }
 
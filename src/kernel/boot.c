@@ -292,14 +292,23 @@ create_root_cnode(void)
 /* Check domain scheduler assumptions. */
 compile_assert(num_domains_valid,
                CONFIG_NUM_DOMAINS >= 1 && CONFIG_NUM_DOMAINS <= 256)
+#ifdef CONFIG_PACKED_READY_QUEUES
+/* limited by the two levels of the ready queue bitmap */
+compile_assert(num_priorities_valid,
+               CONFIG_NUM_PRIORITIES >= 1 && CONFIG_NUM_PRIORITIES <= wordBits * wordBits)
+#else
 compile_assert(num_priorities_valid,
                CONFIG_NUM_PRIORITIES >= 1 && CONFIG_NUM_PRIORITIES <= 256)
+#endif
 
 BOOT_CODE void
 create_domain_cap(cap_t root_cnode_cap)
 {
     /* Check domain scheduler assumptions. */
     assert(ksDomScheduleLength > 0);
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+    assert(ksDomScheduleLength <= CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH);
+#endif
     for (word_t i = 0; i < ksDomScheduleLength; i++) {
         assert(ksDomSchedule[i].domain < CONFIG_NUM_DOMAINS);
         assert(ksDomSchedule[i].length > 0);
@@ -361,7 +370,7 @@ BOOT_CODE void populate_bi_frame(node_id_t node_id, word_t num_nodes,
     bi->numIOPTLevels = 0;
     bi->ipcBuffer = (seL4_IPCBuffer *)ipcbuf_vptr;
     bi->initThreadCNodeSizeBits = CONFIG_ROOT_CNODE_SIZE_BITS;
-    bi->initThreadDomain = ksDomSchedule[ksDomScheduleIdx].domain;
+    bi->initThreadDomain = ksDomSchedule[DOM_STATE(ksDomScheduleIdx)].domain;
     bi->extraLen = extra_bi_size;
 
     ndks_boot.bi_frame = bi;
@@ -535,19 +544,19 @@ BOOT_CODE tcb_t *create_initial_thread(cap_t root_cnode_cap, cap_t it_pd_cap, vp
 
     tcb->tcbPriority = seL4_MaxPrio;
     tcb->tcbMCP = seL4_MaxPrio;
-    tcb->tcbDomain = ksDomSchedule[ksDomScheduleIdx].domain;
+    tcb->tcbDomain = ksDomSchedule[DOM_STATE(ksDomScheduleIdx)].domain;
 #ifndef CONFIG_KERNEL_MCS
     setupReplyMaster(tcb);
 #endif
     setThreadState(tcb, ThreadState_Running);
 
-    ksCurDomain = ksDomSchedule[ksDomScheduleIdx].domain;
+    DOM_STATE(ksCurDomain) = ksDomSchedule[DOM_STATE(ksDomScheduleIdx)].domain;
 #ifdef CONFIG_KERNEL_MCS
-    ksDomainTime = usToTicks(ksDomSchedule[ksDomScheduleIdx].length * US_IN_MS);
+    DOM_STATE(ksDomainTime) = usToTicks(ksDomSchedule[DOM_STATE(ksDomScheduleIdx)].length * US_IN_MS);
 #else
-    ksDomainTime = ksDomSchedule[ksDomScheduleIdx].length;
+    DOM_STATE(ksDomainTime) = ksDomSchedule[DOM_STATE(ksDomScheduleIdx)].length;
 #endif
-    assert(ksCurDomain < CONFIG_NUM_DOMAINS && ksDomainTime > 0);
+    assert(DOM_STATE(ksCurDomain) < CONFIG_NUM_DOMAINS && DOM_STATE(ksDomainTime) > 0);
 
 #ifndef CONFIG_KERNEL_MCS
     SMP_COND_STATEMENT(tcb->tcbAffinity = 0);
@@ -588,8 +597,33 @@ BOOT_CODE void clock_sync_test(void)
 }
 #endif
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* Every core starts on the schedule the kernel was built with */
+BOOT_CODE static void init_domain_schedule(void)
+{
+    word_t length = MIN(ksDomScheduleLength, CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH);
+
+    for (word_t i = 0; i < length; i++) {
+        NODE_STATE(ksDomSchedules)[0][i] = ksDomSchedule[i];
+    }
+    NODE_STATE(ksDomScheduleLengths)[0] = length;
+    NODE_STATE(ksDomScheduleActive) = 0;
+    NODE_STATE(ksDomSchedulePending) = false;
+    NODE_STATE(ksDomScheduleIdx) = 0;
+    NODE_STATE(ksCurDomain) = ksDomSchedule[0].domain;
+#ifdef CONFIG_KERNEL_MCS
+    NODE_STATE(ksDomainTime) = usToTicks(ksDomSchedule[0].length * US_IN_MS);
+#else
+    NODE_STATE(ksDomainTime) = ksDomSchedule[0].length;
+#endif
+}
+#endif
+
 BOOT_CODE void init_core_state(tcb_t *scheduler_action)
 {
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+    init_domain_schedule();
+#endif
 #ifdef CONFIG_HAVE_FPU
     NODE_STATE(ksActiveFPUState) = NULL;
 #endif
@@ -610,6 +644,9 @@ BOOT_CODE void init_core_state(tcb_t *scheduler_action)
     NODE_STATE(ksReprogram) = true;
     NODE_STATE(ksReleaseQueue.head) = NULL;
     NODE_STATE(ksReleaseQueue.end) = NULL;
+#ifdef CONFIG_RELEASE_QUEUE_HEAP
+    NODE_STATE(ksReleaseQueueSize) = 0;
+#endif
     NODE_STATE(ksCurTime) = getCurrentTime();
 #endif
 }
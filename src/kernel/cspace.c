@@ -55,10 +55,22 @@ lookupSlot_raw_ret_t lookupSlot(tcb_t *thread, cptr_t capptr)
     lookupSlot_raw_ret_t ret;
 
     threadRoot = TCB_PTR_CTE_PTR(thread, tcbCTable)->cap;
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    ret.slot = cspaceCacheLookup(threadRoot, capptr);
+    if (likely(ret.slot != NULL)) {
+        ret.status = EXCEPTION_NONE;
+        return ret;
+    }
+#endif
     res_ret = resolveAddressBits(threadRoot, capptr, wordBits);
 
     ret.status = res_ret.status;
     ret.slot = res_ret.slot;
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    if (ret.status == EXCEPTION_NONE) {
+        cspaceCacheInsert(threadRoot, capptr, ret.slot);
+    }
+#endif
     return ret;
 }
 
@@ -219,6 +219,12 @@ void doNormalTransfer(tcb_t *sender, word_t *sendBuffer, endpoint_t *endpoint,
 
     tag = transferCaps(tag, endpoint, receiver, receiveBuffer);
 
+#ifdef CONFIG_MESSAGE_WINDOW
+    if (canGrant) {
+        Arch_transferMessageWindow(sender, receiver);
+    }
+#endif
+
     tag = seL4_MessageInfo_set_length(tag, msgTransferred);
     setRegister(receiver, msgInfoRegister, wordFromMessageInfo(tag));
     setRegister(receiver, badgeRegister, badge);
@@ -299,6 +305,70 @@ void doNBRecvFailedTransfer(tcb_t *thread)
     setRegister(thread, badgeRegister, 0);
 }
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+static void nextDomain(void)
+{
+    dschedule_t *entry;
+
+    NODE_STATE(ksDomScheduleIdx)++;
+    if (NODE_STATE(ksDomScheduleIdx) >= NODE_STATE(ksDomScheduleLengths)[NODE_STATE(ksDomScheduleActive)]) {
+        NODE_STATE(ksDomScheduleIdx) = 0;
+        /* A committed schedule only takes over at the end of the active one */
+        if (NODE_STATE(ksDomSchedulePending)) {
+            NODE_STATE(ksDomScheduleActive) ^= 1;
+            NODE_STATE(ksDomSchedulePending) = false;
+            /* The old schedule stays in the now inactive buffer, but a new
+             * schedule must be written in full before it is committed */
+            for (word_t i = 0; i < DOM_SCHEDULE_BITMAP_SIZE; i++) {
+                NODE_STATE(ksDomScheduleWritten)[i] = 0;
+            }
+        }
+    }
+#ifdef CONFIG_KERNEL_MCS
+    NODE_STATE(ksReprogram) = true;
+#endif
+    ksWorkUnitsCompleted = 0;
+    entry = &NODE_STATE(ksDomSchedules)[NODE_STATE(ksDomScheduleActive)][NODE_STATE(ksDomScheduleIdx)];
+    NODE_STATE(ksCurDomain) = entry->domain;
+#ifdef CONFIG_KERNEL_MCS
+    NODE_STATE(ksDomainTime) = usToTicks(entry->length * US_IN_MS);
+#else
+    NODE_STATE(ksDomainTime) = entry->length;
+#endif
+}
+
+void setDomainScheduleEntry(word_t core, word_t index, dom_t domain, word_t length)
+{
+    word_t inactive = NODE_STATE_ON_CORE(ksDomScheduleActive, core) ^ 1;
+
+    /* Never swap in a schedule that is being changed */
+    NODE_STATE_ON_CORE(ksDomSchedulePending, core) = false;
+    NODE_STATE_ON_CORE(ksDomSchedules, core)[inactive][index].domain = domain;
+    NODE_STATE_ON_CORE(ksDomSchedules, core)[inactive][index].length = length;
+    NODE_STATE_ON_CORE(ksDomScheduleWritten, core)[index >> wordRadix] |= BIT(index & MASK(wordRadix));
+}
+
+bool_t isDomainScheduleConfigured(word_t core, word_t length)
+{
+    /* Entries are checked as they are written, so only unwritten ones are
+     * invalid */
+    for (word_t i = 0; i < length; i++) {
+        if (!(NODE_STATE_ON_CORE(ksDomScheduleWritten, core)[i >> wordRadix] & BIT(i & MASK(wordRadix)))) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void commitDomainSchedule(word_t core, word_t length)
+{
+    word_t inactive = NODE_STATE_ON_CORE(ksDomScheduleActive, core) ^ 1;
+
+    NODE_STATE_ON_CORE(ksDomScheduleLengths, core)[inactive] = length;
+    NODE_STATE_ON_CORE(ksDomSchedulePending, core) = true;
+}
+#else
 static void nextDomain(void)
 {
     ksDomScheduleIdx++;
@@ -316,6 +386,7 @@ static void nextDomain(void)
     ksDomainTime = ksDomSchedule[ksDomScheduleIdx].length;
 #endif
 }
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
 
 #ifdef CONFIG_KERNEL_MCS
 static void switchSchedContext(void)
@@ -342,17 +413,74 @@ static void switchSchedContext(void)
 
 static void scheduleChooseNewThread(void)
 {
-    if (ksDomainTime == 0) {
+    if (DOM_STATE(ksDomainTime) == 0) {
         nextDomain();
     }
     chooseThread();
 }
 
+#ifdef CONFIG_TICKLESS
+/* Does for the ticks that have passed since the timer was last looked at
+ * what timerTick does for a single tick. ksCurThread is still the thread that
+ * was running when the kernel was entered, and it is charged even if the
+ * kernel entry blocked it, as the periodic tick would have charged it before
+ * the entry. */
+static void timerTicks(word_t ticks)
+{
+    if (ticks == 0) {
+        return;
+    }
+
+    if (likely(NODE_STATE(ksCurThread) != NODE_STATE(ksIdleThread))) {
+        if (NODE_STATE(ksCurThread)->tcbTimeSlice > ticks) {
+            NODE_STATE(ksCurThread)->tcbTimeSlice -= ticks;
+        } else {
+            NODE_STATE(ksCurThread)->tcbTimeSlice = CONFIG_TIME_SLICE;
+            if (isRunnable(NODE_STATE(ksCurThread))) {
+                SCHED_APPEND_CURRENT_TCB;
+                rescheduleRequired();
+            }
+        }
+    }
+
+    if (numDomains > 1) {
+        if (DOM_STATE(ksDomainTime) > ticks) {
+            DOM_STATE(ksDomainTime) -= ticks;
+        } else {
+            DOM_STATE(ksDomainTime) = 0;
+            rescheduleRequired();
+        }
+    }
+}
+
+/* The timer is only needed when the timeslice of the thread that is about to
+ * run or the domain time runs out. The timeslice only matters while another
+ * thread of the same priority is ready to take over, and the idle thread has
+ * none. The fastpaths take the slowpath while the timer is stopped, so that
+ * this runs again before they switch to a thread that has peers. */
+static void setNextTimerTick(void)
+{
+    word_t ticks = 0;
+    tcb_t *thread = NODE_STATE(ksCurThread);
+
+    if (thread != NODE_STATE(ksIdleThread) &&
+        READY_QUEUE(DOM_STATE(ksCurDomain), thread->tcbPriority).head != NULL) {
+        ticks = thread->tcbTimeSlice;
+    }
+    if (numDomains > 1 && (ticks == 0 || DOM_STATE(ksDomainTime) < ticks)) {
+        ticks = DOM_STATE(ksDomainTime);
+    }
+    setNextTick(ticks);
+}
+#endif /* CONFIG_TICKLESS */
+
 void schedule(void)
 {
 #ifdef CONFIG_KERNEL_MCS
     awaken();
     checkDomainTime();
+#elif defined(CONFIG_TICKLESS)
+    timerTicks(getElapsedTicks());
 #endif
 
     if (NODE_STATE(ksSchedulerAction) != SchedulerAction_ResumeCurrentThread) {
@@ -377,7 +505,7 @@ void schedule(void)
                 NODE_STATE(ksCurThread) == NODE_STATE(ksIdleThread)
                 || (candidate->tcbPriority < NODE_STATE(ksCurThread)->tcbPriority);
             if (fastfail &&
-                !isHighestPrio(ksCurDomain, candidate->tcbPriority)) {
+                !isHighestPrio(DOM_STATE(ksCurDomain), candidate->tcbPriority)) {
                 SCHED_ENQUEUE(candidate);
                 /* we can't, need to reschedule */
                 NODE_STATE(ksSchedulerAction) = SchedulerAction_ChooseNewThread;
@@ -408,6 +536,8 @@ void schedule(void)
         setNextInterrupt();
         NODE_STATE(ksReprogram) = false;
     }
+#elif defined(CONFIG_TICKLESS)
+    setNextTimerTick();
 #endif
 }
 
@@ -418,14 +548,14 @@ void chooseThread(void)
     tcb_t *thread;
 
     if (numDomains > 1) {
-        dom = ksCurDomain;
+        dom = DOM_STATE(ksCurDomain);
     } else {
         dom = 0;
     }
 
-    if (likely(NODE_STATE(ksReadyQueuesL1Bitmap[dom]))) {
+    if (likely(READY_QUEUES_L1_BITMAP(dom))) {
         prio = getHighestPrio(dom);
-        thread = NODE_STATE(ksReadyQueues)[ready_queues_index(dom, prio)].head;
+        thread = READY_QUEUE(dom, prio).head;
         assert(thread);
         assert(isSchedulable(thread));
 #ifdef CONFIG_KERNEL_MCS
@@ -466,6 +596,10 @@ void switchToIdleThread(void)
 
 void setDomain(tcb_t *tptr, dom_t dom)
 {
+#if defined(CONFIG_RUNTIME_DOMAIN_SCHEDULE) && defined(ENABLE_SMP_SUPPORT)
+    /* The core the thread is running on may be in a different domain */
+    remoteTCBStall(tptr);
+#endif
     tcbSchedDequeue(tptr);
     tptr->tcbDomain = dom;
     if (isSchedulable(tptr)) {
@@ -533,7 +667,7 @@ void possibleSwitchTo(tcb_t *target)
 #ifdef CONFIG_KERNEL_MCS
     if (target->tcbSchedContext != NULL && !thread_state_get_tcbInReleaseQueue(target->tcbState)) {
 #endif
-        if (ksCurDomain != target->tcbDomain
+        if (DOM_STATE(ksCurDomain) != target->tcbDomain
             SMP_COND_STATEMENT( || target->tcbAffinity != getCurrentCPUIndex())) {
             SCHED_ENQUEUE(target);
         } else if (NODE_STATE(ksSchedulerAction) != SchedulerAction_ResumeCurrentThread) {
@@ -578,13 +712,19 @@ void setNextInterrupt(void)
                              refill_head(NODE_STATE(ksCurThread)->tcbSchedContext)->rAmount;
 
     if (numDomains > 1) {
-        next_interrupt = MIN(next_interrupt, NODE_STATE(ksCurTime) + ksDomainTime);
+        next_interrupt = MIN(next_interrupt, NODE_STATE(ksCurTime) + DOM_STATE(ksDomainTime));
     }
 
     if (NODE_STATE(ksReleaseQueue.head) != NULL) {
         next_interrupt = MIN(refill_head(NODE_STATE(ksReleaseQueue.head)->tcbSchedContext)->rTime, next_interrupt);
     }
 
+#ifdef CONFIG_IRQ_RATE_LIMIT
+    if (NODE_STATE(ksIRQDeferred)) {
+        next_interrupt = MIN(MAX(NODE_STATE(ksIRQDeferredDeadline), NODE_STATE(ksCurTime)), next_interrupt);
+    }
+#endif
+
     /* We should never be attempting to schedule anything earlier than ksCurTime */
     assert(next_interrupt >= NODE_STATE(ksCurTime));
 
@@ -653,8 +793,8 @@ void timerTick(void)
     }
 
     if (numDomains > 1) {
-        ksDomainTime--;
-        if (ksDomainTime == 0) {
+        DOM_STATE(ksDomainTime)--;
+        if (DOM_STATE(ksDomainTime) == 0) {
             rescheduleRequired();
         }
     }
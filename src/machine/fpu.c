@@ -39,6 +39,14 @@ void switchFpuOwner(user_fpu_state_t *new_owner, word_t cpu)
     }
 }
 
+#ifdef CONFIG_FPU_EAGER_SWITCH
+void eagerFPURestore(tcb_t *thread)
+{
+    switchLocalFpuOwner(&thread->tcbArch.tcbContext.fpuState);
+    thread->tcbFPUUsage = (thread->tcbFPUUsage + 1) % FPU_EAGER_REPROBE_PERIOD;
+}
+#endif
+
 /* Handle an FPU fault.
  *
  * This CPU exception is thrown when userspace attempts to use the FPU while
@@ -51,6 +59,12 @@ exception_t handleFPUFault(void)
      * we presumably are happy to assume will not be running seL4. */
     assert(!nativeThreadUsingFPU(NODE_STATE(ksCurThread)));
 
+#ifdef CONFIG_FPU_EAGER_SWITCH
+    if (NODE_STATE(ksCurThread)->tcbFPUUsage < CONFIG_FPU_EAGER_THRESHOLD) {
+        NODE_STATE(ksCurThread)->tcbFPUUsage++;
+    }
+#endif
+
     /* Otherwise, lazily switch over the FPU. */
     switchLocalFpuOwner(&NODE_STATE(ksCurThread)->tcbArch.tcbContext.fpuState);
 
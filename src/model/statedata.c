@@ -21,13 +21,21 @@ SMP_STATE_DEFINE(smpStatedata_t, ksSMP[CONFIG_MAX_NUM_NODES] ALIGN(L1_CACHE_LINE
 word_t ksNumCPUs;
 
 /* Pointer to the head of the scheduler queue for each priority */
+#ifdef CONFIG_PACKED_READY_QUEUES
+UP_STATE_DEFINE(ready_queues_t, ksDomainReadyQueues[CONFIG_NUM_DOMAINS]);
+#else
 UP_STATE_DEFINE(tcb_queue_t, ksReadyQueues[NUM_READY_QUEUES]);
 UP_STATE_DEFINE(word_t, ksReadyQueuesL1Bitmap[CONFIG_NUM_DOMAINS]);
 UP_STATE_DEFINE(word_t, ksReadyQueuesL2Bitmap[CONFIG_NUM_DOMAINS][L2_BITMAP_SIZE]);
+#endif
 compile_assert(ksReadyQueuesL1BitmapBigEnough, (L2_BITMAP_SIZE - 1) <= wordBits)
 #ifdef CONFIG_KERNEL_MCS
 /* Head of the queue of threads waiting for their budget to be replenished */
 UP_STATE_DEFINE(tcb_queue_t, ksReleaseQueue);
+#ifdef CONFIG_RELEASE_QUEUE_HEAP
+/* Number of threads in the release queue heap */
+UP_STATE_DEFINE(word_t, ksReleaseQueueSize);
+#endif
 #endif
 
 /* Current thread TCB pointer */
@@ -58,6 +66,11 @@ UP_STATE_DEFINE(ticks_t, ksCurTime);
 UP_STATE_DEFINE(sched_context_t *, ksCurSC);
 UP_STATE_DEFINE(sched_context_t *, ksIdleSC);
 #endif
+#ifdef CONFIG_IRQ_RATE_LIMIT
+UP_STATE_DEFINE(word_t, ksIRQDeferred);
+UP_STATE_DEFINE(ticks_t, ksIRQDeferredDeadline);
+UP_STATE_DEFINE(word_t, ksIRQSuppressed);
+#endif
 
 #ifdef CONFIG_DEBUG_BUILD
 UP_STATE_DEFINE(tcb_t *, ksDebugTCBs);
@@ -70,17 +83,58 @@ UP_STATE_DEFINE(timestamp_t, benchmark_kernel_time);
 UP_STATE_DEFINE(timestamp_t, benchmark_kernel_number_entries);
 UP_STATE_DEFINE(timestamp_t, benchmark_kernel_number_schedules);
 #endif /* CONFIG_BENCHMARK_TRACK_UTILISATION */
+#ifdef CONFIG_BENCHMARK_TRACEPOINTS_RING
+UP_STATE_DEFINE(word_t, benchmark_tracepoint_head);
+#endif /* CONFIG_BENCHMARK_TRACEPOINTS_RING */
+#ifdef CONFIG_BENCHMARK_ENTRY_HISTOGRAMS
+UP_STATE_DEFINE(benchmark_entry_histogram_t, benchmark_entry_histograms[seL4_BenchmarkEntryHistograms + 1]);
+#endif /* CONFIG_BENCHMARK_ENTRY_HISTOGRAMS */
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+UP_STATE_DEFINE(cspace_cache_entry_t, ksCSpaceCache[BIT(CSPACE_LOOKUP_CACHE_BITS)]);
+#endif
 
 /* Units of work we have completed since the last time we checked for
  * pending interrupts */
 word_t ksWorkUnitsCompleted;
 
+#if defined(CONFIG_PREEMPTIBLE_BADGED_SENDS) && defined(CONFIG_KERNEL_MCS)
+/* Number of times a thread has been queued on an endpoint in front of another
+ * thread, which invalidates all cancelBadgedSends cursors */
+word_t ksEPReorders;
+#endif
+
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+/* Changed whenever a CNode cap is added to, removed from or replaced in a
+ * slot, which invalidates the CSpace lookup caches of all cores */
+uint64_t ksCSpaceGeneration;
+#endif
+
 irq_state_t intStateIRQTable[INT_STATE_ARRAY_SIZE];
+#ifdef CONFIG_IRQ_RATE_LIMIT
+irq_rate_limit_t intStateIRQRateLimit[INT_STATE_ARRAY_SIZE];
+#endif
 /* CNode containing interrupt handler endpoints - like all seL4 objects, this CNode needs to be
  * of a size that is a power of 2 and aligned to its size. */
 cte_t intStateIRQNode[BIT(IRQ_CNODE_SLOT_BITS)] ALIGN(BIT(IRQ_CNODE_SLOT_BITS + seL4_SlotBits));
 compile_assert(irqCNodeSize, sizeof(intStateIRQNode) >= ((INT_STATE_ARRAY_SIZE) *sizeof(cte_t)));
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+/* Domain schedules of this core and whether the inactive one is committed */
+UP_STATE_DEFINE(dschedule_t, ksDomSchedules[2][CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH]);
+UP_STATE_DEFINE(word_t, ksDomScheduleLengths[2]);
+UP_STATE_DEFINE(word_t, ksDomScheduleActive);
+UP_STATE_DEFINE(bool_t, ksDomSchedulePending);
+UP_STATE_DEFINE(word_t, ksDomScheduleWritten[DOM_SCHEDULE_BITMAP_SIZE]);
+
+/* Index into the active schedule, current domain and its timeslice remaining */
+UP_STATE_DEFINE(word_t, ksDomScheduleIdx);
+UP_STATE_DEFINE(dom_t, ksCurDomain);
+#ifdef CONFIG_KERNEL_MCS
+UP_STATE_DEFINE(ticks_t, ksDomainTime);
+#else
+UP_STATE_DEFINE(word_t, ksDomainTime);
+#endif
+#else
 /* Currently active domain */
 dom_t ksCurDomain;
 
@@ -93,6 +147,7 @@ word_t ksDomainTime;
 
 /* An index into ksDomSchedule for active domain and length. */
 word_t ksDomScheduleIdx;
+#endif
 
 /* Only used by lockTLBEntry */
 word_t tlbLockCount = 0;
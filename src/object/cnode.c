@@ -328,7 +328,11 @@ exception_t invokeCNodeCancelBadgedSends(cap_t cap)
     if (badge) {
         endpoint_t *ep = (endpoint_t *)
                          cap_endpoint_cap_get_capEPPtr(cap);
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+        return cancelBadgedSends(ep, badge);
+#else
         cancelBadgedSends(ep, badge);
+#endif
     }
     return EXCEPTION_NONE;
 }
@@ -432,6 +436,9 @@ void cteInsert(cap_t newCap, cte_t *srcSlot, cte_t *destSlot)
      * untyped from it. */
     setUntypedCapAsFull(srcCap, newCap, srcSlot);
 
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    cspaceCacheCapChanged(destSlot->cap, newCap);
+#endif
     destSlot->cap = newCap;
     destSlot->cteMDBNode = newMDB;
     mdb_node_ptr_set_mdbNext(&srcSlot->cteMDBNode, CTE_REF(destSlot));
@@ -454,6 +461,9 @@ void cteMove(cap_t newCap, cte_t *srcSlot, cte_t *destSlot)
            (cte_t *)mdb_node_get_mdbPrev(destSlot->cteMDBNode) == NULL);
 
     mdb = srcSlot->cteMDBNode;
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    cspaceCacheCapChanged(srcSlot->cap, newCap);
+#endif
     destSlot->cap = newCap;
     srcSlot->cap = cap_null_cap_new();
     destSlot->cteMDBNode = mdb;
@@ -491,6 +501,9 @@ void cteSwap(cap_t cap1, cte_t *slot1, cap_t cap2, cte_t *slot2)
     mdb_node_t mdb1, mdb2;
     word_t next_ptr, prev_ptr;
 
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    cspaceCacheCapChanged(cap1, cap2);
+#endif
     slot1->cap = cap2;
     slot2->cap = cap1;
 
@@ -525,6 +538,64 @@ void cteSwap(cap_t cap1, cte_t *slot1, cap_t cap2, cte_t *slot2)
             CTE_REF(slot1));
 }
 
+#ifdef CONFIG_BATCHED_REVOKE
+/* Caps whose finalisation neither depends on whether they are final nor
+ * leaves a zombie or cleanup work behind. */
+static inline bool_t CONST capIsBatchRevocable(cap_t cap)
+{
+    switch (cap_get_capType(cap)) {
+    case cap_untyped_cap:
+    case cap_frame_cap:
+#ifdef CONFIG_ARCH_AARCH32
+    case cap_small_frame_cap:
+#endif
+        return true;
+    default:
+        return false;
+    }
+}
+
+/* Deletes the run of batch revocable children of parent starting at first,
+ * which must be the MDB successor of parent. The slots are cleared one by one
+ * and the run is unlinked from the MDB in a single step when the run ends or
+ * the revoke is preempted, instead of relinking the neighbours of every slot. */
+static exception_t revokeBatch(cte_t *parent, cte_t *first)
+{
+    cte_t *next = first;
+    bool_t firstBadged = false;
+    exception_t status;
+
+    do {
+        cte_t *slot = next;
+        finaliseCap_ret_t fc_ret UNUSED;
+
+        next = CTE_PTR(mdb_node_get_mdbNext(slot->cteMDBNode));
+        firstBadged = firstBadged || mdb_node_get_mdbFirstBadged(slot->cteMDBNode);
+
+        /* unmaps mapped frames. Untyped caps need no finalisation, but
+         * finaliseCap only accepts them when the cap is not exposed. */
+        fc_ret = finaliseCap(slot->cap, false, false);
+        assert(cap_get_capType(fc_ret.remainder) == cap_null_cap &&
+               cap_get_capType(fc_ret.cleanupInfo) == cap_null_cap);
+
+        slot->cap = cap_null_cap_new();
+        slot->cteMDBNode = nullMDBNode;
+
+        status = preemptionPoint();
+    } while (status == EXCEPTION_NONE && next &&
+             capIsBatchRevocable(next->cap) && isMDBParentOf(parent, next));
+
+    mdb_node_ptr_set_mdbNext(&parent->cteMDBNode, CTE_REF(next));
+    if (next) {
+        mdb_node_ptr_set_mdbPrev(&next->cteMDBNode, CTE_REF(parent));
+        mdb_node_ptr_set_mdbFirstBadged(&next->cteMDBNode,
+                                        mdb_node_get_mdbFirstBadged(next->cteMDBNode) || firstBadged);
+    }
+
+    return status;
+}
+#endif
+
 exception_t cteRevoke(cte_t *slot)
 {
     cte_t *nextPtr;
@@ -535,6 +606,15 @@ exception_t cteRevoke(cte_t *slot)
     for (nextPtr = CTE_PTR(mdb_node_get_mdbNext(slot->cteMDBNode));
          nextPtr && isMDBParentOf(slot, nextPtr);
          nextPtr = CTE_PTR(mdb_node_get_mdbNext(slot->cteMDBNode))) {
+#ifdef CONFIG_BATCHED_REVOKE
+        if (capIsBatchRevocable(nextPtr->cap)) {
+            status = revokeBatch(slot, nextPtr);
+            if (status != EXCEPTION_NONE) {
+                return status;
+            }
+            continue;
+        }
+#endif
         status = cteDelete(nextPtr, true);
         if (status != EXCEPTION_NONE) {
             return status;
@@ -584,6 +664,9 @@ static void emptySlot(cte_t *slot, cap_t cleanupInfo)
             mdb_node_ptr_set_mdbFirstBadged(&next->cteMDBNode,
                                             mdb_node_get_mdbFirstBadged(next->cteMDBNode) ||
                                             mdb_node_get_mdbFirstBadged(mdbNode));
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+        cspaceCacheCapChanged(slot->cap, cap_null_cap_new());
+#endif
         slot->cap = cap_null_cap_new();
         slot->cteMDBNode = nullMDBNode;
 
@@ -630,6 +713,9 @@ static finaliseSlot_ret_t finaliseSlot(cte_t *slot, bool_t immediate)
             return ret;
         }
 
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+        cspaceCacheCapChanged(slot->cap, fc_ret.remainder);
+#endif
         slot->cap = fc_ret.remainder;
 
         if (!immediate && capCyclicZombie(fc_ret.remainder, slot)) {
@@ -747,6 +833,9 @@ void insertNewCap(cte_t *parent, cte_t *slot, cap_t cap)
     cte_t *next;
 
     next = CTE_PTR(mdb_node_get_mdbNext(parent->cteMDBNode));
+#ifdef CONFIG_CSPACE_LOOKUP_CACHE
+    cspaceCacheCapChanged(slot->cap, cap);
+#endif
     slot->cap = cap;
     slot->cteMDBNode = mdb_node_new(CTE_REF(next), true, true, CTE_REF(parent));
     if (next) {
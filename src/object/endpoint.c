@@ -15,6 +15,9 @@
 #include <object/cnode.h>
 #include <object/endpoint.h>
 #include <object/tcb.h>
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+#include <object/interrupt.h>
+#endif
 
 #ifdef CONFIG_KERNEL_MCS
 void sendIPC(bool_t blocking, bool_t do_call, word_t badge,
@@ -147,6 +150,13 @@ void receiveIPC(tcb_t *thread, cap_t cap, bool_t isBlocking)
 
     /* Check for anything waiting in the notification */
     ntfnPtr = thread->tcbBoundNotification;
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    /* Receiving on the endpoint also receives on the bound notification,
+     * which acks the IRQs that signalled it */
+    if (ntfnPtr && unlikely(gic_num_pending_deactivate)) {
+        ackDeferredIRQs(ntfnPtr);
+    }
+#endif
     if (ntfnPtr && notification_ptr_get_state(ntfnPtr) == NtfnState_Active) {
         completeSignal(ntfnPtr, thread);
     } else {
@@ -388,6 +398,9 @@ void cancelAllIPC(endpoint_t *epptr)
 
         /* Set all blocked threads to restart */
         for (; thread; thread = thread->tcbEPNext) {
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+            releaseCancelCursor(thread);
+#endif
 #ifdef CONFIG_KERNEL_MCS
             reply_t *reply = REPLY_PTR(thread_state_get_replyObject(thread->tcbState));
             if (reply != NULL) {
@@ -422,6 +435,115 @@ void cancelAllIPC(endpoint_t *epptr)
     }
 }
 
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+/* Restart a sender that has been removed from an endpoint queue because its
+ * badge is being cancelled */
+static void restartBadgedSender(tcb_t *thread)
+{
+#ifdef CONFIG_KERNEL_MCS
+    /* senders do not have reply objects in their state, and we are only cancelling sends */
+    assert(REPLY_PTR(thread_state_get_replyObject(thread->tcbState)) == NULL);
+    if (seL4_Fault_get_seL4_FaultType(thread->tcbFault) == seL4_Fault_NullFault) {
+        setThreadState(thread, ThreadState_Restart);
+        if (sc_sporadic(thread->tcbSchedContext)) {
+            /* See cancelAllIPC */
+            assert(thread->tcbSchedContext != NODE_STATE(ksCurSC));
+            if (thread->tcbSchedContext != NODE_STATE(ksCurSC)) {
+                refill_unblock_check(thread->tcbSchedContext);
+            }
+        }
+        possibleSwitchTo(thread);
+    } else {
+        setThreadState(thread, ThreadState_Inactive);
+    }
+#else
+    setThreadState(thread, ThreadState_Restart);
+    SCHED_ENQUEUE(thread);
+#endif
+}
+
+static void setCancelCursor(tcb_t *owner, tcb_t *cursor, word_t badge)
+{
+    /* A sender is the cursor of at most one thread, any previous owner
+     * will rescan its queue from the head */
+    releaseCancelCursor(cursor);
+    owner->tcbCancelCursor = cursor;
+    owner->tcbCancelBadge = badge;
+    cursor->tcbCancelOwner = owner;
+#ifdef CONFIG_KERNEL_MCS
+    owner->tcbCancelReorders = ksEPReorders;
+#endif
+}
+
+/* Take the cursor left by a preempted cancellation of the same badge on the
+ * same endpoint. The cursor is dropped as soon as its thread leaves the queue,
+ * and on MCS whenever a thread is queued in front of another one, so every
+ * sender in front of it has been scanned already. */
+static tcb_t *takeCancelCursor(tcb_t *owner, endpoint_t *epptr, word_t badge)
+{
+    tcb_t *cursor = owner->tcbCancelCursor;
+
+    if (cursor == NULL) {
+        return NULL;
+    }
+    clearCancelCursor(owner);
+
+    if (owner->tcbCancelBadge != badge ||
+        EP_PTR(thread_state_get_blockingObject(cursor->tcbState)) != epptr) {
+        return NULL;
+    }
+#ifdef CONFIG_KERNEL_MCS
+    if (owner->tcbCancelReorders != ksEPReorders) {
+        return NULL;
+    }
+#endif
+
+    return cursor;
+}
+
+exception_t cancelBadgedSends(endpoint_t *epptr, word_t badge)
+{
+    tcb_t *thread, *next;
+    tcb_queue_t queue;
+    exception_t status = EXCEPTION_NONE;
+
+    if (endpoint_ptr_get_state(epptr) != EPState_Send) {
+        clearCancelCursor(NODE_STATE(ksCurThread));
+        return EXCEPTION_NONE;
+    }
+
+    queue = ep_ptr_get_queue(epptr);
+    thread = takeCancelCursor(NODE_STATE(ksCurThread), epptr, badge);
+    if (thread == NULL) {
+        thread = queue.head;
+    }
+
+    for (; thread; thread = next) {
+        next = thread->tcbEPNext;
+        if (thread_state_ptr_get_blockingIPCBadge(&thread->tcbState) == badge) {
+            queue = tcbEPDequeue(thread, queue);
+            restartBadgedSender(thread);
+        }
+
+        if (next) {
+            status = preemptionPoint();
+            if (status != EXCEPTION_NONE) {
+                setCancelCursor(NODE_STATE(ksCurThread), next, badge);
+                break;
+            }
+        }
+    }
+
+    ep_ptr_set_queue(epptr, queue);
+    if (!queue.head) {
+        endpoint_ptr_set_state(epptr, EPState_Idle);
+    }
+
+    rescheduleRequired();
+
+    return status;
+}
+#else
 void cancelBadgedSends(endpoint_t *epptr, word_t badge)
 {
     switch (endpoint_ptr_get_state(epptr)) {
@@ -491,6 +613,7 @@ void cancelBadgedSends(endpoint_t *epptr, word_t badge)
         fail("invalid EP state");
     }
 }
+#endif /* CONFIG_PREEMPTIBLE_BADGED_SENDS */
 
 #ifdef CONFIG_KERNEL_MCS
 void reorderEP(endpoint_t *epptr, tcb_t *thread)
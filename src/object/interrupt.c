@@ -19,6 +19,10 @@
 #include <model/statedata.h>
 #include <machine/timer.h>
 #include <smp/ipi.h>
+#ifdef CONFIG_IRQ_RATE_LIMIT
+#include <mode/api/ipc_buffer.h>
+#include <kernel/sporadic.h>
+#endif
 
 exception_t decodeIRQControlInvocation(word_t invLabel, word_t length,
                                        cte_t *srcSlot, word_t *buffer)
@@ -83,7 +87,7 @@ exception_t invokeIRQControl(irq_t irq, cte_t *handlerSlot, cte_t *controlSlot)
     return EXCEPTION_NONE;
 }
 
-exception_t decodeIRQHandlerInvocation(word_t invLabel, irq_t irq)
+exception_t decodeIRQHandlerInvocation(word_t invLabel, irq_t irq, word_t length, word_t *buffer)
 {
     switch (invLabel) {
     case IRQAckIRQ:
@@ -124,6 +128,53 @@ exception_t decodeIRQHandlerInvocation(word_t invLabel, irq_t irq)
         invokeIRQHandler_ClearIRQHandler(irq);
         return EXCEPTION_NONE;
 
+#ifdef CONFIG_IRQ_RATE_LIMIT
+    case IRQSetRateLimit: {
+        time_t interval_us;
+
+        if (length < TIME_ARG_SIZE) {
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        interval_us = mode_parseTimeArg(0, buffer);
+
+        if (interval_us != 0 &&
+            (interval_us > MAX_PERIOD_US || usToTicks(interval_us) < MIN_BUDGET)) {
+            userError("IRQHandler SetRateLimit: interval out of range.");
+            current_syscall_error.type = seL4_RangeError;
+            current_syscall_error.rangeErrorMin = MIN_BUDGET_US;
+            current_syscall_error.rangeErrorMax = MAX_PERIOD_US;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        invokeIRQHandler_SetRateLimit(irq, interval_us == 0 ? 0 : usToTicks(interval_us));
+        return EXCEPTION_NONE;
+    }
+#endif
+
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    case ARMIRQHandlerSetDeferredDeactivate: {
+        bool_t defer;
+
+        if (length < 1) {
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+        defer = !!getSyscallArg(0, buffer);
+
+        if (IRQT_TO_IRQ(irq) < SPI_START) {
+            userError("IRQHandler SetDeferredDeactivate: IRQ %u is not an SPI.", (int)IRQT_TO_IRQ(irq));
+            current_syscall_error.type = seL4_IllegalOperation;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        invokeIRQHandler_SetDeferredDeactivate(irq, defer);
+        return EXCEPTION_NONE;
+    }
+#endif
+
     default:
         userError("IRQHandler: Illegal operation.");
         current_syscall_error.type = seL4_IllegalOperation;
@@ -133,6 +184,14 @@ exception_t decodeIRQHandlerInvocation(word_t invLabel, irq_t irq)
 
 void invokeIRQHandler_AckIRQ(irq_t irq)
 {
+#ifdef CONFIG_IRQ_RATE_LIMIT
+    if (intStateIRQRateLimit[IRQT_TO_IDX(irq)].deferred) {
+        /* The line stays masked until the held back interrupt has been
+         * delivered, which user level then acks. */
+        return;
+    }
+#endif
+
 #ifdef CONFIG_ARCH_RISCV
 #if !defined(CONFIG_PLAT_QEMU_RISCV_VIRT)
     /* QEMU has a bug where interrupts must be
@@ -148,11 +207,140 @@ void invokeIRQHandler_AckIRQ(irq_t irq)
         doRemoteMaskPrivateInterrupt(IRQT_TO_CORE(irq), false, IRQT_TO_IDX(irq));
         return;
     }
+#endif
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    deactivateInterrupt(irq);
 #endif
     maskInterrupt(false, irq);
 #endif
 }
 
+#ifdef CONFIG_IRQ_RATE_LIMIT
+static void deliverIRQ(word_t idx)
+{
+    cap_t cap = intStateIRQNode[idx].cap;
+
+    if (cap_get_capType(cap) == cap_notification_cap &&
+        cap_notification_cap_get_capNtfnCanSend(cap)) {
+        sendSignal(NTFN_PTR(cap_notification_cap_get_capNtfnPtr(cap)),
+                   cap_notification_cap_get_capNtfnBadge(cap));
+    }
+}
+
+void invokeIRQHandler_SetRateLimit(irq_t irq, ticks_t interval)
+{
+    irq_rate_limit_t *limit = &intStateIRQRateLimit[IRQT_TO_IDX(irq)];
+
+    limit->interval = interval;
+    if (interval == 0 && limit->deferred) {
+        /* Deliver the held back interrupt now. The count of the core that
+         * deferred it is corrected when its timer fires. */
+        limit->deferred = false;
+        deliverIRQ(IRQT_TO_IDX(irq));
+    }
+}
+
+/* Returns true if the interrupt arrived within the minimum interval after
+ * the previous delivery. The line is then kept masked and the interrupt is
+ * delivered from the timer interrupt once the interval has passed. */
+static bool_t rateLimitIRQ(irq_t irq)
+{
+    irq_rate_limit_t *limit = &intStateIRQRateLimit[IRQT_TO_IDX(irq)];
+
+    if (likely(limit->interval == 0)) {
+        return false;
+    }
+
+    if (!limit->deferred && limit->next <= NODE_STATE(ksCurTime)) {
+        limit->next = NODE_STATE(ksCurTime) + limit->interval;
+        return false;
+    }
+
+    if (!limit->deferred) {
+        limit->deferred = true;
+#ifdef ENABLE_SMP_SUPPORT
+        limit->core = getCurrentCPUIndex();
+#endif
+        if (NODE_STATE(ksIRQDeferred) == 0 || limit->next < NODE_STATE(ksIRQDeferredDeadline)) {
+            NODE_STATE(ksIRQDeferredDeadline) = limit->next;
+            NODE_STATE(ksReprogram) = true;
+        }
+        NODE_STATE(ksIRQDeferred)++;
+    }
+    NODE_STATE(ksIRQSuppressed)++;
+
+#ifndef CONFIG_ARCH_RISCV
+    maskInterrupt(true, irq);
+#endif
+    return true;
+}
+
+/* Deliver the deferred interrupts of this core whose interval has passed,
+ * and recompute the deadline of the remaining ones. */
+static void deliverDeferredIRQs(void)
+{
+    word_t remaining = 0;
+    ticks_t deadline = 0;
+
+    for (word_t idx = 0; idx < INT_STATE_ARRAY_SIZE; idx++) {
+        irq_rate_limit_t *limit = &intStateIRQRateLimit[idx];
+
+        if (!limit->deferred) {
+            continue;
+        }
+#ifdef ENABLE_SMP_SUPPORT
+        if (limit->core != getCurrentCPUIndex()) {
+            continue;
+        }
+#endif
+        if (limit->next <= NODE_STATE(ksCurTime) + getKernelWcetTicks()) {
+            limit->deferred = false;
+            limit->next = NODE_STATE(ksCurTime) + limit->interval;
+            deliverIRQ(idx);
+        } else {
+            if (remaining == 0 || limit->next < deadline) {
+                deadline = limit->next;
+            }
+            remaining++;
+        }
+    }
+
+    NODE_STATE(ksIRQDeferred) = remaining;
+    NODE_STATE(ksIRQDeferredDeadline) = deadline;
+}
+#endif
+
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+void invokeIRQHandler_SetDeferredDeactivate(irq_t irq, bool_t defer)
+{
+    setDeactivationDeferred(irq, defer);
+    if (!defer && isDeactivationPending(irq)) {
+        /* Leave the IRQ in the state it would be in without the deferral:
+         * masked until user level acks it. */
+        maskInterrupt(true, irq);
+        deactivateInterrupt(irq);
+    }
+}
+
+void ackDeferredIRQs(notification_t *ntfnPtr)
+{
+    for (word_t i = 0; i < GIC_IRQ_BITMAP_WORDS && gic_num_pending_deactivate; i++) {
+        word_t pending = gic_pending_deactivate[i];
+        while (pending) {
+            word_t bit = wordBits - 1 - clzl(pending);
+            irq_t irq = IDX_TO_IRQT(i * wordBits + bit);
+            cap_t cap = intStateIRQNode[i * wordBits + bit].cap;
+
+            pending &= ~BIT(bit);
+            if (cap_get_capType(cap) == cap_notification_cap &&
+                NTFN_PTR(cap_notification_cap_get_capNtfnPtr(cap)) == ntfnPtr) {
+                deactivateInterrupt(irq);
+            }
+        }
+    }
+}
+#endif
+
 void invokeIRQHandler_SetIRQHandler(irq_t irq, cap_t cap, cte_t *slot)
 {
     cte_t *irqSlot;
@@ -184,6 +372,16 @@ void deletingIRQHandler(irq_t irq)
 void deletedIRQHandler(irq_t irq)
 {
     setIRQState(IRQInactive, irq);
+#ifdef CONFIG_IRQ_RATE_LIMIT
+    /* The next handler for this IRQ starts without a rate limit */
+    intStateIRQRateLimit[IRQT_TO_IDX(irq)].interval = 0;
+    intStateIRQRateLimit[IRQT_TO_IDX(irq)].deferred = false;
+#endif
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    /* The next handler for this IRQ starts in the default mode */
+    setDeactivationDeferred(irq, false);
+    deactivateInterrupt(irq);
+#endif
 }
 
 void handleInterrupt(irq_t irq)
@@ -207,6 +405,11 @@ void handleInterrupt(irq_t irq)
          * requires an update in the proofs first. Might be a c89 legacy.
          */
         cap_t cap;
+#ifdef CONFIG_IRQ_RATE_LIMIT
+        if (unlikely(rateLimitIRQ(irq))) {
+            break;
+        }
+#endif
         cap = intStateIRQNode[IRQT_TO_IDX(irq)].cap;
         if (cap_get_capType(cap) == cap_notification_cap &&
             cap_notification_cap_get_capNtfnCanSend(cap)) {
@@ -217,6 +420,14 @@ void handleInterrupt(irq_t irq)
             printf("Undelivered IRQ: %d\n", (int)IRQT_TO_IRQ(irq));
 #endif
         }
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+        if (isDeactivationDeferred(irq)) {
+            /* Keep the IRQ active instead of masking it, until user level
+             * acks it or receives on the notification again. */
+            deferDeactivation(irq);
+            break;
+        }
+#endif
 #ifndef CONFIG_ARCH_RISCV
         maskInterrupt(true, irq);
 #endif
@@ -226,7 +437,14 @@ void handleInterrupt(irq_t irq)
     case IRQTimer:
 #ifdef CONFIG_KERNEL_MCS
         ackDeadlineIRQ();
+#ifdef CONFIG_IRQ_RATE_LIMIT
+        if (NODE_STATE(ksIRQDeferred)) {
+            deliverDeferredIRQs();
+        }
+#endif
         NODE_STATE(ksReprogram) = true;
+#elif defined(CONFIG_TICKLESS)
+        /* the ticks that have passed are counted in schedule() */
 #else
         timerTick();
         resetTimer();
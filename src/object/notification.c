@@ -15,6 +15,9 @@
 #include <machine/io.h>
 
 #include <object/notification.h>
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+#include <object/interrupt.h>
+#endif
 
 static inline tcb_queue_t PURE ntfn_ptr_get_queue(notification_t *ntfnPtr)
 {
@@ -193,6 +196,13 @@ void receiveSignal(tcb_t *thread, cap_t cap, bool_t isBlocking)
 
     ntfnPtr = NTFN_PTR(cap_notification_cap_get_capNtfnPtr(cap));
 
+#ifdef CONFIG_ARM_GIC_V3_DEFERRED_DEACTIVATE
+    /* Receiving again acks the IRQs that signalled this notification */
+    if (unlikely(gic_num_pending_deactivate)) {
+        ackDeferredIRQs(ntfnPtr);
+    }
+#endif
+
     switch (notification_ptr_get_state(ntfnPtr)) {
     case NtfnState_Idle:
     case NtfnState_Waiting: {
@@ -198,6 +198,9 @@ finaliseCap_ret_t finaliseCap(cap_t cap, bool_t final, bool_t exposed)
             }
 #endif
             suspend(tcb);
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+            clearCancelCursor(tcb);
+#endif
 #ifdef CONFIG_DEBUG_BUILD
             tcbDebugRemove(tcb);
 #endif
@@ -530,7 +533,7 @@ cap_t createObject(object_t t, void *regionBase, word_t userSize, bool_t deviceM
 #ifndef CONFIG_KERNEL_MCS
         tcb->tcbTimeSlice = CONFIG_TIME_SLICE;
 #endif
-        tcb->tcbDomain = ksCurDomain;
+        tcb->tcbDomain = DOM_STATE(ksCurDomain);
 #ifndef CONFIG_KERNEL_MCS
         /* Initialize the new TCB to the current core */
         SMP_COND_STATEMENT(tcb->tcbAffinity = getCurrentCPUIndex());
@@ -758,7 +761,8 @@ exception_t decodeInvocation(word_t invLabel, word_t length,
 
     case cap_irq_handler_cap:
         return decodeIRQHandlerInvocation(invLabel,
-                                          IDX_TO_IRQT(cap_irq_handler_cap_get_capIRQ(cap)));
+                                          IDX_TO_IRQT(cap_irq_handler_cap_get_capIRQ(cap)),
+                                          length, buffer);
 
 #ifdef CONFIG_KERNEL_MCS
     case cap_sched_control_cap:
@@ -14,6 +14,7 @@
 #include <object/structures.h>
 #include <object/objecttype.h>
 #include <object/cnode.h>
+#include <object/endpoint.h>
 #ifdef CONFIG_KERNEL_MCS
 #include <object/schedcontext.h>
 #endif
@@ -57,12 +58,12 @@ static inline void addToBitmap(word_t cpu, word_t dom, word_t prio)
     l1index = prio_to_l1index(prio);
     l1index_inverted = invert_l1index(l1index);
 
-    NODE_STATE_ON_CORE(ksReadyQueuesL1Bitmap[dom], cpu) |= BIT(l1index);
+    READY_QUEUES_L1_BITMAP_ON_CORE(dom, cpu) |= BIT(l1index);
     /* we invert the l1 index when accessed the 2nd level of the bitmap in
        order to increase the liklihood that high prio threads l2 index word will
        be on the same cache line as the l1 index word - this makes sure the
        fastpath is fastest for high prio threads */
-    NODE_STATE_ON_CORE(ksReadyQueuesL2Bitmap[dom][l1index_inverted], cpu) |= BIT(prio & MASK(wordRadix));
+    READY_QUEUES_L2_BITMAP_ON_CORE(dom, l1index_inverted, cpu) |= BIT(prio & MASK(wordRadix));
 }
 
 static inline void removeFromBitmap(word_t cpu, word_t dom, word_t prio)
@@ -72,9 +73,9 @@ static inline void removeFromBitmap(word_t cpu, word_t dom, word_t prio)
 
     l1index = prio_to_l1index(prio);
     l1index_inverted = invert_l1index(l1index);
-    NODE_STATE_ON_CORE(ksReadyQueuesL2Bitmap[dom][l1index_inverted], cpu) &= ~BIT(prio & MASK(wordRadix));
-    if (unlikely(!NODE_STATE_ON_CORE(ksReadyQueuesL2Bitmap[dom][l1index_inverted], cpu))) {
-        NODE_STATE_ON_CORE(ksReadyQueuesL1Bitmap[dom], cpu) &= ~BIT(l1index);
+    READY_QUEUES_L2_BITMAP_ON_CORE(dom, l1index_inverted, cpu) &= ~BIT(prio & MASK(wordRadix));
+    if (unlikely(!READY_QUEUES_L2_BITMAP_ON_CORE(dom, l1index_inverted, cpu))) {
+        READY_QUEUES_L1_BITMAP_ON_CORE(dom, cpu) &= ~BIT(l1index);
     }
 }
 
@@ -123,18 +124,16 @@ void tcbSchedEnqueue(tcb_t *tcb)
         tcb_queue_t queue;
         dom_t dom;
         prio_t prio;
-        word_t idx;
 
         dom = tcb->tcbDomain;
         prio = tcb->tcbPriority;
-        idx = ready_queues_index(dom, prio);
-        queue = NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity);
+        queue = READY_QUEUE_ON_CORE(dom, prio, tcb->tcbAffinity);
 
         if (tcb_queue_empty(queue)) {
             addToBitmap(SMP_TERNARY(tcb->tcbAffinity, 0), dom, prio);
         }
 
-        NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity) = tcb_queue_prepend(queue, tcb);
+        READY_QUEUE_ON_CORE(dom, prio, tcb->tcbAffinity) = tcb_queue_prepend(queue, tcb);
 
         thread_state_ptr_set_tcbQueued(&tcb->tcbState, true);
     }
@@ -152,18 +151,16 @@ void tcbSchedAppend(tcb_t *tcb)
         tcb_queue_t queue;
         dom_t dom;
         prio_t prio;
-        word_t idx;
 
         dom = tcb->tcbDomain;
         prio = tcb->tcbPriority;
-        idx = ready_queues_index(dom, prio);
-        queue = NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity);
+        queue = READY_QUEUE_ON_CORE(dom, prio, tcb->tcbAffinity);
 
         if (tcb_queue_empty(queue)) {
             addToBitmap(SMP_TERNARY(tcb->tcbAffinity, 0), dom, prio);
         }
 
-        NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity) = tcb_queue_append(queue, tcb);
+        READY_QUEUE_ON_CORE(dom, prio, tcb->tcbAffinity) = tcb_queue_append(queue, tcb);
 
         thread_state_ptr_set_tcbQueued(&tcb->tcbState, true);
     }
@@ -177,16 +174,14 @@ void tcbSchedDequeue(tcb_t *tcb)
         tcb_queue_t new_queue;
         dom_t dom;
         prio_t prio;
-        word_t idx;
 
         dom = tcb->tcbDomain;
         prio = tcb->tcbPriority;
-        idx = ready_queues_index(dom, prio);
-        queue = NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity);
+        queue = READY_QUEUE_ON_CORE(dom, prio, tcb->tcbAffinity);
 
         new_queue = tcb_queue_remove(queue, tcb);
 
-        NODE_STATE_ON_CORE(ksReadyQueues[idx], tcb->tcbAffinity) = new_queue;
+        READY_QUEUE_ON_CORE(dom, prio, tcb->tcbAffinity) = new_queue;
 
         thread_state_ptr_set_tcbQueued(&tcb->tcbState, false);
 
@@ -254,6 +249,9 @@ tcb_queue_t tcbEPAppend(tcb_t *tcb, tcb_queue_t queue)
 /* Remove TCB from an endpoint queue */
 tcb_queue_t tcbEPDequeue(tcb_t *tcb, tcb_queue_t queue)
 {
+#ifdef CONFIG_PREEMPTIBLE_BADGED_SENDS
+    releaseCancelCursor(tcb);
+#endif
     if (tcb->tcbEPPrev) {
         tcb->tcbEPPrev->tcbEPNext = tcb->tcbEPNext;
     } else {
@@ -271,26 +269,163 @@ tcb_queue_t tcbEPDequeue(tcb_t *tcb, tcb_queue_t queue)
 
 #ifdef CONFIG_KERNEL_MCS
 
-void tcbReleaseRemove(tcb_t *tcb)
+static inline ticks_t PURE tcbReadyTime(tcb_t *tcb)
 {
-    if (likely(thread_state_get_tcbInReleaseQueue(tcb->tcbState))) {
-        tcb_queue_t queue = NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity);
+    return refill_head(tcb->tcbSchedContext)->rTime;
+}
 
-        if (queue.head == tcb) {
-            NODE_STATE_ON_CORE(ksReprogram, tcb->tcbAffinity) = true;
-        }
+#ifdef CONFIG_RELEASE_QUEUE_HEAP
+/* The release queue is kept as a binary min-heap ordered by tcbReadyTime,
+ * with the root in queue.head so the earliest release is found in O(1). The
+ * heap is a complete binary tree of ksReleaseQueueSize threads, so the depth
+ * and with it the worst-case cost of every insertion and removal is
+ * logarithmic. Within the heap, tcbSchedPrev points to a thread's parent,
+ * tcbEPNext to its left child and tcbEPPrev to its right child: threads in
+ * the release queue are runnable, so they are never in an endpoint or
+ * notification queue. tcbSchedNext is unused. */
 
-        NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) = tcb_queue_remove(queue, tcb);
+/* Return the link that points to the thread at the 1-based position pos,
+ * walking down from the root along the bits of pos below its top bit. */
+static tcb_t **tcb_heap_link(tcb_t **root, word_t pos)
+{
+    tcb_t **link = root;
+    word_t bit;
 
-        thread_state_ptr_set_tcbInReleaseQueue(&tcb->tcbState, false);
+    assert(pos != 0);
+    for (bit = BIT(wordBits - 1 - clzl(pos)) >> 1; bit != 0; bit >>= 1) {
+        link = (pos & bit) ? &(*link)->tcbEPPrev : &(*link)->tcbEPNext;
     }
+
+    return link;
 }
 
-static inline ticks_t PURE tcbReadyTime(tcb_t *tcb)
+/* Point the link that refers to old, from its parent or the root, to new */
+static void tcb_heap_replace_link(tcb_t **root, tcb_t *old, tcb_t *new)
 {
-    return refill_head(tcb->tcbSchedContext)->rTime;
+    tcb_t *parent = old->tcbSchedPrev;
+
+    if (parent == NULL) {
+        *root = new;
+    } else if (parent->tcbEPNext == old) {
+        parent->tcbEPNext = new;
+    } else {
+        parent->tcbEPPrev = new;
+    }
+}
+
+/* Exchange the positions of parent and its child */
+static void tcb_heap_swap(tcb_t **root, tcb_t *parent, tcb_t *child)
+{
+    tcb_t *left = child->tcbEPNext;
+    tcb_t *right = child->tcbEPPrev;
+    tcb_t *sibling;
+
+    tcb_heap_replace_link(root, parent, child);
+    child->tcbSchedPrev = parent->tcbSchedPrev;
+
+    if (parent->tcbEPNext == child) {
+        sibling = parent->tcbEPPrev;
+        child->tcbEPNext = parent;
+        child->tcbEPPrev = sibling;
+    } else {
+        sibling = parent->tcbEPNext;
+        child->tcbEPNext = sibling;
+        child->tcbEPPrev = parent;
+    }
+    if (sibling) {
+        sibling->tcbSchedPrev = child;
+    }
+
+    parent->tcbSchedPrev = child;
+    parent->tcbEPNext = left;
+    parent->tcbEPPrev = right;
+    if (left) {
+        left->tcbSchedPrev = parent;
+    }
+    if (right) {
+        right->tcbSchedPrev = parent;
+    }
+}
+
+/* Restore the heap order around tcb after it was placed at a new position,
+ * moving it up towards the root or down towards the leaves */
+static void tcb_heap_sift(tcb_t **root, tcb_t *tcb)
+{
+    ticks_t time = tcbReadyTime(tcb);
+
+    while (tcb->tcbSchedPrev != NULL && time < tcbReadyTime(tcb->tcbSchedPrev)) {
+        tcb_heap_swap(root, tcb->tcbSchedPrev, tcb);
+    }
+
+    while (tcb->tcbEPNext != NULL) {
+        tcb_t *child = tcb->tcbEPNext;
+
+        if (tcb->tcbEPPrev != NULL && tcbReadyTime(tcb->tcbEPPrev) < tcbReadyTime(child)) {
+            child = tcb->tcbEPPrev;
+        }
+        if (tcbReadyTime(child) >= time) {
+            break;
+        }
+        tcb_heap_swap(root, tcb, child);
+    }
 }
 
+static tcb_queue_t tcb_heap_insert(tcb_queue_t queue, word_t *size, tcb_t *tcb)
+{
+    (*size)++;
+
+    tcb->tcbSchedNext = NULL;
+    tcb->tcbEPNext = NULL;
+    tcb->tcbEPPrev = NULL;
+
+    if (*size == 1) {
+        tcb->tcbSchedPrev = NULL;
+        queue.head = tcb;
+    } else {
+        tcb_t *parent = *tcb_heap_link(&queue.head, *size >> 1);
+
+        tcb->tcbSchedPrev = parent;
+        if (*size & 1) {
+            parent->tcbEPPrev = tcb;
+        } else {
+            parent->tcbEPNext = tcb;
+        }
+        tcb_heap_sift(&queue.head, tcb);
+    }
+
+    return queue;
+}
+
+static tcb_queue_t tcb_heap_remove(tcb_queue_t queue, word_t *size, tcb_t *tcb)
+{
+    tcb_t **link = tcb_heap_link(&queue.head, *size);
+    tcb_t *last = *link;
+
+    /* detach the last thread, then move it into the place of tcb */
+    *link = NULL;
+    (*size)--;
+
+    if (last != tcb) {
+        tcb_heap_replace_link(&queue.head, tcb, last);
+        last->tcbSchedPrev = tcb->tcbSchedPrev;
+        last->tcbEPNext = tcb->tcbEPNext;
+        last->tcbEPPrev = tcb->tcbEPPrev;
+        if (last->tcbEPNext) {
+            last->tcbEPNext->tcbSchedPrev = last;
+        }
+        if (last->tcbEPPrev) {
+            last->tcbEPPrev->tcbSchedPrev = last;
+        }
+        tcb_heap_sift(&queue.head, last);
+    }
+
+    tcb->tcbSchedPrev = NULL;
+    tcb->tcbEPNext = NULL;
+    tcb->tcbEPPrev = NULL;
+
+    return queue;
+}
+#else
 static inline bool_t PURE time_after(tcb_t *tcb, ticks_t new_time)
 {
     return tcb != NULL && new_time >= tcbReadyTime(tcb);
@@ -306,6 +441,27 @@ static tcb_t *find_time_after(tcb_t *tcb, ticks_t new_time)
 
     return after;
 }
+#endif /* CONFIG_RELEASE_QUEUE_HEAP */
+
+void tcbReleaseRemove(tcb_t *tcb)
+{
+    if (likely(thread_state_get_tcbInReleaseQueue(tcb->tcbState))) {
+        tcb_queue_t queue = NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity);
+
+        if (queue.head == tcb) {
+            NODE_STATE_ON_CORE(ksReprogram, tcb->tcbAffinity) = true;
+        }
+
+#ifdef CONFIG_RELEASE_QUEUE_HEAP
+        NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) =
+            tcb_heap_remove(queue, &NODE_STATE_ON_CORE(ksReleaseQueueSize, tcb->tcbAffinity), tcb);
+#else
+        NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) = tcb_queue_remove(queue, tcb);
+#endif
+
+        thread_state_ptr_set_tcbInReleaseQueue(&tcb->tcbState, false);
+    }
+}
 
 void tcbReleaseEnqueue(tcb_t *tcb)
 {
@@ -318,6 +474,13 @@ void tcbReleaseEnqueue(tcb_t *tcb)
     new_time = tcbReadyTime(tcb);
     queue = NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity);
 
+#ifdef CONFIG_RELEASE_QUEUE_HEAP
+    if (tcb_queue_empty(queue) || new_time < tcbReadyTime(queue.head)) {
+        NODE_STATE_ON_CORE(ksReprogram, tcb->tcbAffinity) = true;
+    }
+    NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) =
+        tcb_heap_insert(queue, &NODE_STATE_ON_CORE(ksReleaseQueueSize, tcb->tcbAffinity), tcb);
+#else
     if (tcb_queue_empty(queue) || new_time < tcbReadyTime(queue.head)) {
         NODE_STATE_ON_CORE(ksReleaseQueue, tcb->tcbAffinity) = tcb_queue_prepend(queue, tcb);
         NODE_STATE_ON_CORE(ksReprogram, tcb->tcbAffinity) = true;
@@ -330,6 +493,7 @@ void tcbReleaseEnqueue(tcb_t *tcb)
             tcb_queue_insert(tcb, after);
         }
     }
+#endif
 
     thread_state_ptr_set_tcbInReleaseQueue(&tcb->tcbState, true);
 }
@@ -441,9 +605,16 @@ word_t copyMRs(tcb_t *sender, word_t *sendBuf, tcb_t *receiver,
     }
 
     /* Copy out-of-line words */
+#ifdef CONFIG_IPC_BURST_COPY
+    if (i < n) {
+        copyIPCBufferWords(&recvBuf[i + 1], &sendBuf[i + 1], n - i);
+        i = n;
+    }
+#else
     for (; i < n; i++) {
         recvBuf[i + 1] = sendBuf[i + 1];
     }
+#endif
 
     return i;
 }
@@ -453,16 +624,22 @@ word_t copyMRs(tcb_t *sender, word_t *sendBuf, tcb_t *receiver,
  * decision made by the scheduler. If its a case, an `irq_reschedule_ipi` is sent */
 void remoteQueueUpdate(tcb_t *tcb)
 {
-    /* only ipi if the target is for the current domain */
-    if (tcb->tcbAffinity != getCurrentCPUIndex() && tcb->tcbDomain == ksCurDomain) {
+    /* only ipi if the target is for the current domain of its core */
+    if (tcb->tcbAffinity != getCurrentCPUIndex() &&
+        tcb->tcbDomain == DOM_STATE_ON_CORE(ksCurDomain, tcb->tcbAffinity)) {
         tcb_t *targetCurThread = NODE_STATE_ON_CORE(ksCurThread, tcb->tcbAffinity);
 
         /* reschedule if the target core is idle or we are waking a higher priority thread (or
-         * if a new irq would need to be set on MCS) */
+         * if a new irq would need to be set on MCS, or if the target stopped its timer because
+         * its thread had no peer of the same priority) */
         if (targetCurThread == NODE_STATE_ON_CORE(ksIdleThread, tcb->tcbAffinity)  ||
             tcb->tcbPriority > targetCurThread->tcbPriority
 #ifdef CONFIG_KERNEL_MCS
             || NODE_STATE_ON_CORE(ksReprogram, tcb->tcbAffinity)
+#endif
+#ifdef CONFIG_TICKLESS
+            || (tcb->tcbPriority == targetCurThread->tcbPriority &&
+                ARCH_NODE_STATE_ON_CORE(x86KStimerCount, tcb->tcbAffinity) == 0)
 #endif
            ) {
             ARCH_NODE_STATE(ipiReschedulePending) |= BIT(tcb->tcbAffinity);
@@ -877,6 +1054,14 @@ exception_t decodeTCBInvocation(word_t invLabel, word_t length, cap_t cap,
         return decodeSetEPTRoot(cap);
 #endif
 
+#ifdef CONFIG_MESSAGE_WINDOW
+    case TCBSetMessageWindow:
+        return decodeSetMessageWindow(cap, length, buffer);
+
+    case TCBTakeMessageWindow:
+        return decodeTakeMessageWindow(cap, length, buffer);
+#endif
+
 #ifdef CONFIG_HARDWARE_DEBUG_API
     case TCBConfigureSingleStepping:
         return decodeConfigureSingleStepping(cap, call, buffer);
@@ -1575,11 +1760,120 @@ exception_t decodeSetSpace(cap_t cap, word_t length, cte_t *slot, word_t *buffer
 #endif
 }
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+static exception_t decodeDomainScheduleConfigure(word_t length, word_t *buffer)
+{
+    word_t core, index, domain, entryLength;
+
+    if (unlikely(length < 4)) {
+        userError("Domain ScheduleConfigure: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    core = getSyscallArg(0, buffer);
+    index = getSyscallArg(1, buffer);
+    domain = getSyscallArg(2, buffer);
+    entryLength = getSyscallArg(3, buffer);
+
+    if (unlikely(core >= ksNumCPUs)) {
+        userError("Domain ScheduleConfigure: invalid core (%lu >= %lu).", core, ksNumCPUs);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(index >= CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH)) {
+        userError("Domain ScheduleConfigure: invalid index %lu.", index);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 0;
+        current_syscall_error.rangeErrorMax = CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH - 1;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(domain >= numDomains)) {
+        userError("Domain ScheduleConfigure: invalid domain (%lu >= %u).",
+                  domain, numDomains);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 2;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(entryLength == 0)) {
+        userError("Domain ScheduleConfigure: entry length must not be 0.");
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 3;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+#ifdef CONFIG_KERNEL_MCS
+    /* the length is in ms and is converted to ticks when the entry starts */
+    if (unlikely(entryLength > MAX_PERIOD_US / US_IN_MS)) {
+        userError("Domain ScheduleConfigure: invalid length %lu.", entryLength);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = MAX_PERIOD_US / US_IN_MS;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+#endif
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    setDomainScheduleEntry(core, index, domain, entryLength);
+    return EXCEPTION_NONE;
+}
+
+static exception_t decodeDomainScheduleCommit(word_t length, word_t *buffer)
+{
+    word_t core, scheduleLength;
+
+    if (unlikely(length < 2)) {
+        userError("Domain ScheduleCommit: Truncated message.");
+        current_syscall_error.type = seL4_TruncatedMessage;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+    core = getSyscallArg(0, buffer);
+    scheduleLength = getSyscallArg(1, buffer);
+
+    if (unlikely(core >= ksNumCPUs)) {
+        userError("Domain ScheduleCommit: invalid core (%lu >= %lu).", core, ksNumCPUs);
+        current_syscall_error.type = seL4_InvalidArgument;
+        current_syscall_error.invalidArgumentNumber = 0;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(scheduleLength == 0 || scheduleLength > CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH)) {
+        userError("Domain ScheduleCommit: invalid length %lu.", scheduleLength);
+        current_syscall_error.type = seL4_RangeError;
+        current_syscall_error.rangeErrorMin = 1;
+        current_syscall_error.rangeErrorMax = CONFIG_DOMAIN_SCHEDULE_MAX_LENGTH;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    if (unlikely(!isDomainScheduleConfigured(core, scheduleLength))) {
+        userError("Domain ScheduleCommit: schedule has unconfigured entries.");
+        current_syscall_error.type = seL4_IllegalOperation;
+        return EXCEPTION_SYSCALL_ERROR;
+    }
+
+    setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+    commitDomainSchedule(core, scheduleLength);
+    return EXCEPTION_NONE;
+}
+#endif /* CONFIG_RUNTIME_DOMAIN_SCHEDULE */
+
 exception_t decodeDomainInvocation(word_t invLabel, word_t length, word_t *buffer)
 {
     word_t domain;
     cap_t tcap;
 
+#ifdef CONFIG_RUNTIME_DOMAIN_SCHEDULE
+    if (invLabel == DomainSetScheduleConfigure) {
+        return decodeDomainScheduleConfigure(length, buffer);
+    }
+    if (invLabel == DomainSetScheduleCommit) {
+        return decodeDomainScheduleCommit(length, buffer);
+    }
+#endif
+
     if (unlikely(invLabel != DomainSetSet)) {
         current_syscall_error.type = seL4_IllegalOperation;
         return EXCEPTION_SYSCALL_ERROR;
@@ -16,6 +16,7 @@
 #include <object/cnode.h>
 #include <kernel/cspace.h>
 #include <kernel/thread.h>
+#include <arch/smp/ipi_inline.h>
 #include <util.h>
 
 static word_t alignUp(word_t baseValue, word_t alignment)
@@ -39,6 +40,43 @@ exception_t decodeUntypedInvocation(word_t invLabel, word_t length, cte_t *slot,
     word_t freeIndex;
     bool_t deviceMemory;
     bool_t reset;
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+    bool_t map = invLabel == UntypedRetypeMap;
+    cap_t vspaceCap = cap_null_cap_new();
+    word_t vaddr = 0, rightsMask = 0, attr = 0;
+#endif
+
+#ifdef CONFIG_UNTYPED_RESET
+    if (invLabel == UntypedReset) {
+        /* Resetting is only safe once nothing refers to the memory. */
+        status = ensureNoChildren(slot);
+        if (status != EXCEPTION_NONE) {
+            userError("Untyped Reset: Untyped has children, revoke first.");
+            return status;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        return invokeUntyped_Reset(slot);
+    }
+#endif
+
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+    if (map) {
+        /* The retype arguments are followed by the mapping arguments. */
+        if (length < 9 || current_extra_caps.excaprefs[0] == NULL ||
+            current_extra_caps.excaprefs[1] == NULL) {
+            userError("Untyped RetypeMap: Truncated message.");
+            current_syscall_error.type = seL4_TruncatedMessage;
+            return EXCEPTION_SYSCALL_ERROR;
+        }
+
+        vaddr      = getSyscallArg(6, buffer);
+        rightsMask = getSyscallArg(7, buffer);
+        attr       = getSyscallArg(8, buffer);
+        vspaceCap  = current_extra_caps.excaprefs[1]->cap;
+        invLabel   = UntypedRetype;
+    }
+#endif
 
     /* Ensure operation is valid. */
     if (invLabel != UntypedRetype) {
@@ -225,6 +263,21 @@ exception_t decodeUntypedInvocation(word_t invLabel, word_t length, cte_t *slot,
      * size. */
     alignedFreeRef = alignUp(freeRef, objectSize);
 
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+    if (map) {
+        status = Arch_decodeUntypedRetypeMap(newType, nodeWindow, vspaceCap, vaddr);
+        if (status != EXCEPTION_NONE) {
+            return status;
+        }
+
+        setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
+        return invokeUntyped_RetypeMap(slot, reset,
+                                       (void *)alignedFreeRef, newType, userObjSize,
+                                       destCNode, nodeOffset, nodeWindow, deviceMemory,
+                                       vspaceCap, vaddr, rightsMask, attr);
+    }
+#endif
+
     /* Perform the retype. */
     setThreadState(NODE_STATE(ksCurThread), ThreadState_Restart);
     return invokeUntyped_Retype(slot, reset,
@@ -242,6 +295,12 @@ static exception_t resetUntypedCap(cte_t *srcSlot)
     exception_t status;
     bool_t deviceMemory = cap_untyped_cap_get_capIsDevice(prev_cap);
 
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    /* The region may hold frames unmapped earlier in this kernel entry, whose
+     * remote invalidations are still queued */
+    shootdownFlush();
+#endif
+
     if (offset == 0) {
         return EXCEPTION_NONE;
     }
@@ -270,6 +329,16 @@ static exception_t resetUntypedCap(cte_t *srcSlot)
     return EXCEPTION_NONE;
 }
 
+#ifdef CONFIG_UNTYPED_RESET
+exception_t invokeUntyped_Reset(cte_t *srcSlot)
+{
+    /* resetUntypedCap lowers the free index after each chunk it zeroes, so a
+     * preempted reset restarts from there and a later retype finds only the
+     * memory below the free index still dirty. */
+    return resetUntypedCap(srcSlot);
+}
+#endif
+
 exception_t invokeUntyped_Retype(cte_t *srcSlot,
                                  bool_t reset, void *retypeBase,
                                  object_t newType, word_t userSize,
@@ -281,6 +350,11 @@ exception_t invokeUntyped_Retype(cte_t *srcSlot,
     void *regionBase = WORD_PTR(cap_untyped_cap_get_capPtr(srcSlot->cap));
     exception_t status;
 
+#ifdef CONFIG_X86_DEFERRED_SHOOTDOWN
+    /* Other cores must not reach the new objects through stale translations */
+    shootdownFlush();
+#endif
+
     if (reset) {
         status = resetUntypedCap(srcSlot);
         if (status != EXCEPTION_NONE) {
@@ -304,3 +378,26 @@ exception_t invokeUntyped_Retype(cte_t *srcSlot,
 
     return EXCEPTION_NONE;
 }
+
+#ifdef CONFIG_UNTYPED_RETYPE_MAP
+exception_t invokeUntyped_RetypeMap(cte_t *srcSlot, bool_t reset,
+                                    void *retypeBase, object_t newType, word_t userSize,
+                                    cte_t *destCNode, word_t destOffset, word_t destLength,
+                                    bool_t deviceMemory, cap_t vspaceCap, vptr_t vaddr,
+                                    word_t rightsMask, word_t attr)
+{
+    exception_t status;
+
+    /* Only the reset can be preempted, and it happens before any object is
+     * created, so a restarted invocation decodes and retypes again. */
+    status = invokeUntyped_Retype(srcSlot, reset, retypeBase, newType, userSize,
+                                  destCNode, destOffset, destLength, deviceMemory);
+    if (status != EXCEPTION_NONE) {
+        return status;
+    }
+
+    Arch_performUntypedRetypeMap(destCNode + destOffset, destLength, vspaceCap,
+                                 vaddr, rightsMask, attr);
+    return EXCEPTION_NONE;
+}
+#endif
@@ -61,6 +61,10 @@ void ipiStallCoreCallback(bool_t irqPath)
         /* make sure no resource access passes from this point */
         asm volatile("" ::: "memory");
 
+#ifdef CONFIG_SMP_NODE_LOCKS
+        node_lock_exclude_all(getCurrentCPUIndex());
+#endif
+
         /* Start idle thread to capture the pending IPI */
         activateThread();
         restore_user_context();
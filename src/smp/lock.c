@@ -11,6 +11,10 @@
 
 clh_lock_t big_kernel_lock ALIGN(L1_CACHE_LINE_SIZE);
 
+#ifdef CONFIG_SMP_NODE_LOCKS
+node_locks_t node_locks ALIGN(L1_CACHE_LINE_SIZE);
+#endif
+
 BOOT_CODE void clh_lock_init(void)
 {
     for (int i = 0; i < CONFIG_MAX_NUM_NODES; i++) {
@@ -454,6 +454,41 @@ ptr_union_writer_template = \
     """(v%(base)d %(w_shift_op)s %(shift)d) & 0x%(mask)x%(suf)s;
 }"""
 
+multi_writer_template = \
+    """%(inline)s %(block)s_t CONST
+%(block)s_mset_%(fields)s(%(block)s_t %(block)s, %(params)s) {
+    /* fail if user has passed bits that we will override */
+%(asserts)s
+
+%(updates)s
+    return %(block)s;
+}"""
+
+ptr_multi_writer_template = \
+    """%(inline)s void
+%(block)s_ptr_mset_%(fields)s(%(block)s_t *%(block)s_ptr, %(params)s) {
+    /* fail if user has passed bits that we will override */
+%(asserts)s
+
+%(updates)s
+}"""
+
+multi_reader_template = \
+    """%(inline)s void
+%(block)s_mget_%(fields)s(%(block)s_t %(block)s, %(params)s) {
+%(loads)s
+
+%(reads)s
+}"""
+
+ptr_multi_reader_template = \
+    """%(inline)s void
+%(block)s_ptr_mget_%(fields)s(%(block)s_t *%(block)s_ptr, %(params)s) {
+%(loads)s
+
+%(reads)s
+}"""
+
 tag_reader_header_template = \
     """%(inline)s %(type)s CONST
 %(union)s_get_%(tagname)s(%(union)s_t %(union)s) {
@@ -2744,6 +2779,10 @@ class Block:
             emit_named("%s_ptr_set_%s" % (self.name, field), params,
                        ptr_writer_template % subs)
 
+        # Multi-field accessors
+        for name, is_ptr, kind, fields in params.multi_names.get(self.name, []):
+            self.generate_multi(params, name, is_ptr, kind, fields)
+
     def make_names(self, union=None):
         "Return the set of candidate function names for a block"
 
@@ -2788,6 +2827,140 @@ class Block:
 
         return names
 
+    def field_access(self, field):
+        "Return the word index, shifts and masks used to access a field"
+
+        offset, size, high = self.field_map[field]
+        if high:
+            write_shift = ">>"
+            read_shift = "<<"
+            shift = self.base_bits - size - (offset % self.base)
+            if shift < 0:
+                shift = -shift
+                write_shift = "<<"
+                read_shift = ">>"
+            if self.base_sign_extend:
+                high_bits = ((self.base_sign_extend << (
+                    self.base - self.base_bits)) - 1) << self.base_bits
+            else:
+                high_bits = 0
+        else:
+            write_shift = "<<"
+            read_shift = ">>"
+            shift = offset % self.base
+            high_bits = 0
+
+        return {"index": offset // self.base,
+                "shift": shift,
+                "r_shift_op": read_shift,
+                "w_shift_op": write_shift,
+                "mask": ((1 << size) - 1) << (offset % self.base),
+                "high_bits": high_bits,
+                "sign_extend": self.base_sign_extend and high}
+
+    def split_multi_fields(self, fields):
+        """Split the field part of a multi-field accessor name into distinct
+        field names, or return None if that is not possible"""
+
+        if fields in self.field_map:
+            return [fields]
+
+        for field in self.field_map:
+            if fields.startswith(field + '_'):
+                rest = self.split_multi_fields(fields[len(field) + 1:])
+                if rest is not None and field not in rest:
+                    return [field] + rest
+
+        return None
+
+    def make_multi_names(self, tokens):
+        """Return the multi-field accessors among tokens that belong to this
+        block, as (name, is_ptr, kind, fields) tuples"""
+
+        # Blocks in tagged unions only get the standard union accessors
+        if self.tagged:
+            return []
+
+        multi_names = []
+        for token in sorted(tokens):
+            for is_ptr, kind in itertools.product([False, True], ['mget', 'mset']):
+                prefix = "%s_%s%s_" % (self.name, "ptr_" if is_ptr else "", kind)
+                if not token.startswith(prefix):
+                    continue
+
+                fields = self.split_multi_fields(token[len(prefix):])
+                if fields is not None and len(fields) > 1:
+                    multi_names.append((token, is_ptr, kind, fields))
+
+        return multi_names
+
+    def generate_multi(self, params, name, is_ptr, kind, fields):
+        """Generate a multi-field accessor. Fields that share a word are read
+        with one load and written with one store; a word is stored without
+        being read first when the accessor overwrites every field in it."""
+
+        type = TYPES[options.environment][self.base]
+        suf = self.constant_suffix
+        accesses = [(field, self.field_access(field)) for field in fields]
+        words = sorted(set(access["index"] for _field, access in accesses))
+        var = ("%s_ptr->" if is_ptr else "%s.") % self.name
+
+        subs = {
+            "inline": INLINE[options.environment],
+            "block": self.name,
+            "fields": '_'.join(fields)}
+
+        if kind == 'mset':
+            asserts = [
+                "    %s((((~0x%x%s %s %d) | 0x%x) & %s) == "
+                "((%d && (%s & (1%s << (%d)))) ? 0x%x : 0));"
+                % (ASSERTS[options.environment], a["mask"], suf, a["r_shift_op"],
+                   a["shift"], a["high_bits"], field, a["sign_extend"], field,
+                   suf, self.base_bits - 1, a["high_bits"])
+                for field, a in accesses]
+
+            updates = []
+            for index in words:
+                word_accesses = [(f, a) for f, a in accesses if a["index"] == index]
+                word_fields = set(f for f, offset, _size, _high in self.fields
+                                  if offset // self.base == index)
+                value = "\n        | ".join(
+                    "((%s %s %d) & 0x%x%s)" % (f, a["w_shift_op"], a["shift"], a["mask"], suf)
+                    for f, a in word_accesses)
+
+                if word_fields <= set(fields):
+                    updates.append("    %swords[%d] = %s;" % (var, index, value))
+                else:
+                    mask = reduce(lambda x, y: x | y, [a["mask"] for _f, a in word_accesses])
+                    updates.append("    %swords[%d] = (%swords[%d] & ~0x%x%s)\n        | %s;"
+                                   % (var, index, var, index, mask, suf, value))
+
+            subs["params"] = ', '.join("%s %s" % (type, field) for field in fields)
+            subs["asserts"] = '\n'.join(asserts)
+            subs["updates"] = '\n'.join(updates)
+            template = ptr_multi_writer_template if is_ptr else multi_writer_template
+        else:
+            loads = ["    %s w%d = %swords[%d];" % (type, index, var, index)
+                     for index in words]
+
+            reads = []
+            for field, a in accesses:
+                reads.append("    *%s = (w%d & 0x%x%s) %s %d;"
+                             % (field, a["index"], a["mask"], suf, a["r_shift_op"], a["shift"]))
+                if a["sign_extend"]:
+                    reads.append("    /* Possibly sign extend */\n"
+                                 "    if (__builtin_expect(!!(*%s & (1%s << (%d))), 1)) {\n"
+                                 "        *%s |= 0x%x;\n"
+                                 "    }"
+                                 % (field, suf, self.base_bits - 1, field, a["high_bits"]))
+
+            subs["params"] = ', '.join("%s *%s" % (type, field) for field in fields)
+            subs["loads"] = '\n'.join(loads)
+            subs["reads"] = '\n'.join(reads)
+            template = ptr_multi_reader_template if is_ptr else multi_reader_template
+
+        emit_named(name, params, template % subs)
+
 
 temp_output_files = []
 
@@ -2866,6 +3039,10 @@ if __name__ == '__main__':
                       help="switch on generator debug output")
     parser.add_option('--from_file', action='store', default=None,
                       help="original source file before preprocessing")
+    parser.add_option('--multi_field', action='store_true', default=False,
+                      help="generate multi-field accessors (<block>_[ptr_]mget_<field>_<field>... "
+                           "and <block>_[ptr_]mset_<field>_<field>...) for names mentioned in "
+                           "the pruning files. Only for C output.")
 
     options, args = parser.parse_args()
     DEBUG = options.debug
@@ -2949,6 +3126,10 @@ if __name__ == '__main__':
         name_list += e.make_names()
 
     name_list = set(name_list)
+    # Multi-field accessors are only generated on demand, skipping any that
+    # the pruning files already define by hand
+    multi_tokens = set()
+    hand_written = set()
     if len(options.prune_files) > 0:
         search_re = re.compile('[a-zA-Z0-9_]+')
 
@@ -2959,9 +3140,25 @@ if __name__ == '__main__':
 
             matched_tokens = set(search_re.findall(string))
             pruned_names.update(matched_tokens & name_list)
+
+            if options.multi_field:
+                tokens = set(token for token in matched_tokens
+                             if '_mget_' in token or '_mset_' in token)
+                multi_tokens.update(tokens)
+                hand_written.update(
+                    token for token in tokens
+                    if re.search(r'\b(void|[a-zA-Z0-9_]+_t)\s+%s\s*\(' % token, string))
     else:
         pruned_names = name_list
 
+    options.multi_names = {}
+    if options.multi_field and not (options.hol_defs or options.hol_proofs):
+        for b in det_values(blocks):
+            multi_names = b.make_multi_names(multi_tokens - hand_written)
+            if len(multi_names) > 0:
+                options.multi_names[b.name] = multi_names
+                pruned_names.update(name for name, _ptr, _kind, _fields in multi_names)
+
     options.names = pruned_names
 
     # Generate the output
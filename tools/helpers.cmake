@@ -141,6 +141,10 @@ function(GenHBFTarget environment target_name target_file pbf_path pbf_target pr
         get_absolute_source_or_binary(prune_absolute "${prune}")
         list(APPEND args "--prune" "${prune_absolute}")
     endforeach()
+    # Multi-field accessors have no generated proofs, so only offer them to unverified kernels
+    if("${environment}" STREQUAL "" AND NOT KernelVerificationBuild)
+        list(APPEND args --multi_field)
+    endif()
     list(APPEND args --from_file "${orig_file}")
     list(APPEND deps ${prunes})
     GenBFTarget("${args}" "${target_name}" "${target_file}" "${pbf_path}" "${pbf_target}" "${deps}")
@@ -47,6 +47,12 @@ KERNEL_HEADER_TEMPLATE = """/*
 
 #define SYSCALL_MAX (-1)
 #define SYSCALL_MIN ({{syscall_min}})
+{%- for condition, list in optional %}
+#if {{condition}}
+#define SYSCALL_OPTIONAL_MAX ({{list[0][1]}})
+#define SYSCALL_OPTIONAL_MIN ({{list[-1][1]}})
+#endif /* {{condition}} */
+{%- endfor %}
 
 #ifndef __ASSEMBLER__
 
@@ -131,9 +137,16 @@ def parse_args():
     return result
 
 
+def child_configs(element):
+    # The config elements of a syscall list, without the config elements that
+    # are nested in their conditions
+    return [node for node in element.childNodes
+            if node.nodeType == node.ELEMENT_NODE and node.tagName == "config"]
+
+
 def parse_syscall_list(element):
     syscalls = []
-    for config in element.getElementsByTagName("config"):
+    for config in child_configs(element):
         config_condition = condition_to_cpp(config.getElementsByTagName("condition"))
         config_syscalls = []
         for syscall in config.getElementsByTagName("syscall"):
@@ -162,17 +175,31 @@ def parse_xml(xml_file, mcs):
               file=sys.stderr)
         sys.exit(-1)
 
-    configs = api[0].getElementsByTagName("config")
-    if len(configs) != 1:
-        print("Error: api element only supports 1 config element",
+    # The API syscalls are checked with a simple range check. A second config
+    # element with a condition holds optional API syscalls, which are numbered
+    # after the debug syscalls so that they do not move any other number.
+    configs = child_configs(api[0])
+    if len(configs) > 2:
+        print("Error: api element only supports 2 config elements",
               file=sys.stderr)
         sys.exit(-1)
 
-    if len(configs[0].getAttribute("name")) != 0:
-        print("Error: api element config only supports an empty name",
+    if len(configs[0].getElementsByTagName("condition")) != 0:
+        print("Error: first api element config cannot have a condition",
               file=sys.stderr)
         sys.exit(-1)
 
+    if len(configs) > 1 and len(configs[1].getElementsByTagName("condition")) == 0:
+        print("Error: second api element config must have a condition",
+              file=sys.stderr)
+        sys.exit(-1)
+
+    for config in configs:
+        if len(config.getAttribute("name")) != 0:
+            print("Error: api element config only supports an empty name",
+                  file=sys.stderr)
+            sys.exit(-1)
+
     # debug elements are optional
     debug = doc.getElementsByTagName("debug")
     if len(debug) != 1:
@@ -201,6 +228,14 @@ def map_syscalls_neg(syscalls):
     return [(cond, [(s, next(r)) for s in lst]) for (cond, lst) in syscalls]
 
 
+def number_syscalls(api, debug):
+    # Number the API syscalls, then the debug syscalls, then the optional API
+    # syscalls of the second api config. Returns the numbered API, debug and
+    # optional lists.
+    numbered = map_syscalls_neg(api[:1] + debug + api[1:])
+    return (numbered[:1], numbered[1:len(debug) + 1], numbered[len(debug) + 1:])
+
+
 def generate_kernel_file(kernel_header, api, debug):
     # We require jinja2 to be at least version 2.10,
     # In the past we used the 'namespace' feature from that version.
@@ -213,17 +248,20 @@ def generate_kernel_file(kernel_header, api, debug):
 
     template = Environment(loader=BaseLoader, trim_blocks=False,
                            lstrip_blocks=False).from_string(KERNEL_HEADER_TEMPLATE)
-    data = template.render({'assembler': map_syscalls_neg(api),
-                            'enum': map_syscalls_neg(api + debug),
+    (api, debug, optional) = number_syscalls(api, debug)
+    data = template.render({'assembler': api + optional,
+                            'enum': api + debug + optional,
                             'upper': convert_to_assembler_format,
-                            'syscall_min': -sum([len(lst) for (cond, lst) in api])})
+                            'syscall_min': api[0][1][-1][1],
+                            'optional': optional})
     kernel_header.write(data)
 
 
-def generate_libsel4_file(libsel4_header, syscalls):
+def generate_libsel4_file(libsel4_header, api, debug):
+    (api, debug, optional) = number_syscalls(api, debug)
     template = Environment(loader=BaseLoader, trim_blocks=False,
                            lstrip_blocks=False).from_string(LIBSEL4_HEADER_TEMPLATE)
-    data = template.render({'enum': map_syscalls_neg(syscalls)})
+    data = template.render({'enum': api + debug + optional})
     libsel4_header.write(data)
 
 
@@ -238,5 +276,5 @@ if __name__ == "__main__":
         args.kernel_header.close()
 
     if (args.libsel4_header is not None):
-        generate_libsel4_file(args.libsel4_header, api + debug)
+        generate_libsel4_file(args.libsel4_header, api, debug)
         args.libsel4_header.close()